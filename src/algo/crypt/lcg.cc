@@ -16,16 +16,19 @@
 // along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
 
 #include "algo/crypt/lcg.h"
-#include <functional>
 #include <stdexcept>
+#include "algo/range.h"
 
 using namespace au;
 using namespace au::algo::crypt;
 
+static const u32 msvc_multiplier = 0x343FD;
+static const u32 msvc_increment = 0x269EC3;
+
 struct Lcg::Priv final
 {
+    LcgKind kind;
     u32 seed;
-    std::function<u32(u32&)> next;
 };
 
 static inline u32 minstd(u32 &seed, u32 a, u32 q, u32 r, u32 m)
@@ -40,36 +43,35 @@ static inline u32 minstd(u32 &seed, u32 a, u32 q, u32 r, u32 m)
     return x * 4.656612875245797e-10 * 256;
 }
 
+static inline u32 park_miller(u32 &seed)
+{
+    return minstd(seed, 16807, 127773, 2836, 2147483647);
+}
+
+static inline u32 park_miller_revised(u32 &seed)
+{
+    return minstd(seed, 48271, 44488, 3399, 2147483647);
+}
+
+static inline u32 msvc_output(const u32 seed)
+{
+    return (seed >> 16) & 0x7FFF;
+}
+
 Lcg::Lcg(LcgKind kind, u32 seed) : p(new Priv)
 {
-    p->seed = seed;
     switch (kind)
     {
         case LcgKind::MicrosoftVisualC:
-            p->next = [](u32 &seed)
-            {
-                seed = seed * 0x343FD + 0x269EC3;
-                return (seed >> 16) & 0x7FFF;
-            };
-            break;
-
         case LcgKind::ParkMiller:
-            p->next = [](u32 &seed)
-            {
-                return minstd(seed, 16807, 127773, 2836, 2147483647);
-            };
-            break;
-
         case LcgKind::ParkMillerRevised:
-            p->next = [](u32 &seed)
-            {
-                return minstd(seed, 48271, 44488, 3399, 2147483647);
-            };
             break;
 
         default:
             throw std::logic_error("Unknown LCG kind");
     }
+    p->kind = kind;
+    p->seed = seed;
 }
 
 Lcg::~Lcg()
@@ -78,5 +80,45 @@ Lcg::~Lcg()
 
 u32 Lcg::next()
 {
-    return p->next(p->seed);
+    switch (p->kind)
+    {
+        case LcgKind::MicrosoftVisualC:
+            p->seed = p->seed * msvc_multiplier + msvc_increment;
+            return msvc_output(p->seed);
+
+        case LcgKind::ParkMiller:
+            return park_miller(p->seed);
+
+        case LcgKind::ParkMillerRevised:
+            return park_miller_revised(p->seed);
+    }
+    throw std::logic_error("Unknown LCG kind");
+}
+
+void Lcg::fill(u32 *output, const size_t count)
+{
+    switch (p->kind)
+    {
+        case LcgKind::MicrosoftVisualC:
+            for_each_lcg_state(
+                p->seed,
+                msvc_multiplier,
+                msvc_increment,
+                count,
+                [output](const size_t i, const u32 seed)
+                {
+                    output[i] = msvc_output(seed);
+                });
+            break;
+
+        case LcgKind::ParkMiller:
+            for (const auto i : algo::range(count))
+                output[i] = park_miller(p->seed);
+            break;
+
+        case LcgKind::ParkMillerRevised:
+            for (const auto i : algo::range(count))
+                output[i] = park_miller_revised(p->seed);
+            break;
+    }
 }
@@ -17,7 +17,9 @@
 
 #pragma once
 
+#include <array>
 #include <memory>
+#include "algo/range.h"
 #include "types.h"
 
 namespace au {
@@ -38,9 +40,56 @@ namespace crypt {
         ~Lcg();
         u32 next();
 
+        // Same as calling next() count times, without the per-call overhead.
+        void fill(u32 *output, const size_t count);
+
     private:
         struct Priv;
         std::unique_ptr<Priv> p;
     };
 
+    // Calls output(i, state) with each of the next count states of the LCG
+    // state = state * multiplier + increment, and leaves state at the last
+    // one. It runs lane_count interleaved generators, each jumping
+    // lane_count steps at a time, so that the output loop carries no
+    // dependency from one state to the next.
+    template<typename T, typename F> void for_each_lcg_state(
+        T &state,
+        const T multiplier,
+        const T increment,
+        const size_t count,
+        const F &output)
+    {
+        static const size_t lane_count = 8;
+
+        std::array<T, lane_count> lanes;
+        T jump_multiplier = 1;
+        T jump_increment = 0;
+        T lane_state = state;
+        for (const auto i : algo::range(lane_count))
+        {
+            lane_state = lane_state * multiplier + increment;
+            lanes[i] = lane_state;
+            jump_multiplier *= multiplier;
+            jump_increment = jump_increment * multiplier + increment;
+        }
+
+        // lanes[i] holds the state for output offset + i.
+        const auto bulk_count = count - count % lane_count;
+        for (size_t offset = 0; offset < bulk_count; offset += lane_count)
+        {
+            state = lanes[lane_count - 1];
+            for (const auto i : algo::range(lane_count))
+            {
+                output(offset + i, lanes[i]);
+                lanes[i] = lanes[i] * jump_multiplier + jump_increment;
+            }
+        }
+        for (const auto i : algo::range(count - bulk_count))
+        {
+            output(bulk_count + i, lanes[i]);
+            state = lanes[i];
+        }
+    }
+
 } } }
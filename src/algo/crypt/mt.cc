@@ -17,6 +17,7 @@
 // along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
 
 #include "algo/crypt/mt.h"
+#include <algorithm>
 #include <array>
 #include "algo/range.h"
 
@@ -111,40 +112,80 @@ MersenneTwister::~MersenneTwister()
 {
 }
 
-u32 MersenneTwister::next_u32()
+// Regenerates the whole state at once. The twist is written without the
+// usual mag01 lookup so that each loop can be vectorized: within a loop,
+// no word depends on one written less than a vector's width before it.
+static void regenerate(u32 *mt)
+{
+    const auto twist = [](const u32 a, const u32 b, const u32 c)
+    {
+        const u32 y = (a & upper_mask) | (b & lower_mask);
+        return c ^ (y >> 1) ^ ((0 - (y & 1)) & matrix_a);
+    };
+
+    for (auto kk = 0; kk < n - m; kk++)
+        mt[kk] = twist(mt[kk], mt[kk + 1], mt[kk + m]);
+    for (auto kk = n - m; kk < n - 1; kk++)
+        mt[kk] = twist(mt[kk], mt[kk + 1], mt[kk + (m - n)]);
+    mt[n - 1] = twist(mt[n - 1], mt[0], mt[m - 1]);
+}
+
+static inline u32 temper(u32 y)
 {
-    u32 y;
-    static const u32 mag01[2] = {0x0, matrix_a};
+    y ^= tempering_shift_u(y);
+    y ^= tempering_shift_s(y) & tempering_mask_b;
+    y ^= tempering_shift_t(y) & tempering_mask_c;
+    y ^= tempering_shift_l(y);
+    return y;
+}
 
+// Returns the next run of untempered state words, at most size long, and
+// stores its actual length in size.
+const u32 *MersenneTwister::next_run(size_t &size)
+{
     if (p->mti >= n)
     {
-        int kk;
-
         if (p->mti == n + 1)
             p->seed_func(p.get(), p->default_seed);
+        regenerate(p->mt.data());
+        p->mti = 0;
+    }
+    size = std::min<size_t>(size, n - p->mti);
+    const auto run = p->mt.data() + p->mti;
+    p->mti += size;
+    return run;
+}
 
-        for (kk = 0; kk < n - m; kk++)
-        {
-            y = (p->mt[kk] & upper_mask) | (p->mt[kk + 1] & lower_mask);
-            p->mt[kk] = p->mt[kk + m] ^ (y >> 1) ^ mag01[y & 0x1];
-        }
-
-        for (; kk < n - 1; kk++)
-        {
-            y = (p->mt[kk] & upper_mask) | (p->mt[kk + 1] & lower_mask);
-            p->mt[kk] = p->mt[kk + (m - n)] ^ (y >> 1) ^ mag01[y & 0x1];
-        }
-
-        y = (p->mt[n - 1] & upper_mask) | (p->mt[0] & lower_mask);
-        p->mt[n - 1] = p->mt[m - 1] ^ (y >> 1) ^ mag01[y & 0x1];
+u32 MersenneTwister::next_u32()
+{
+    size_t size = 1;
+    return temper(*next_run(size));
+}
 
-        p->mti = 0;
+void MersenneTwister::fill(u32 *output, const size_t count)
+{
+    size_t left = count;
+    while (left)
+    {
+        auto run_size = left;
+        const auto run = next_run(run_size);
+        for (const auto i : algo::range(run_size))
+            output[i] = temper(run[i]);
+        output += run_size;
+        left -= run_size;
     }
+}
 
-    y = p->mt[p->mti++];
-    y ^= tempering_shift_u(y);
-    y ^= tempering_shift_s(y) & tempering_mask_b;
-    y ^= tempering_shift_t(y) & tempering_mask_c;
-    y ^= tempering_shift_l(y);
-    return y;
+void MersenneTwister::xor_stream(u8 *data, const size_t size)
+{
+    size_t left = size;
+    while (left)
+    {
+        auto run_size = left;
+        const auto run = next_run(run_size);
+        for (const auto i : algo::range(run_size))
+            data[i] ^= temper(run[i]);
+        data += run_size;
+        left -= run_size;
+    }
 }
@@ -37,8 +37,16 @@ namespace crypt {
 
         u32 next_u32();
 
+        // Same as calling next_u32() count times, without the per-call
+        // overhead.
+        void fill(u32 *output, const size_t count);
+
+        // data[i] ^= next_u32() (truncated to a byte)
+        void xor_stream(u8 *data, const size_t size);
+
     private:
         struct Priv;
+        const u32 *next_run(size_t &size);
         MersenneTwister(
             const std::function<void(Priv*, const u32)> seed_func,
             const u32 default_seed);
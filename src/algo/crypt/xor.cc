@@ -0,0 +1,95 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#include "algo/crypt/xor.h"
+#include <algorithm>
+#include "algo/range.h"
+#include "err.h"
+
+using namespace au;
+using namespace au::algo::crypt;
+
+void algo::crypt::xor_constant(u8 *data, const size_t size, const u8 key)
+{
+    for (const auto i : algo::range(size))
+        data[i] ^= key;
+}
+
+void algo::crypt::xor_repeating(
+    u8 *data,
+    const size_t size,
+    const u8 *key,
+    const size_t key_size,
+    const size_t key_pos)
+{
+    if (!size)
+        return;
+    if (!key_size)
+        throw err::BadDataSizeError();
+
+    // Going key-sized chunk by chunk avoids a modulo per byte and leaves
+    // a plain loop over two arrays.
+    size_t offset = 0;
+    size_t chunk_key_pos = key_pos % key_size;
+    while (offset < size)
+    {
+        const auto chunk_size
+            = std::min(key_size - chunk_key_pos, size - offset);
+        const auto chunk_ptr = data + offset;
+        const auto chunk_key_ptr = key + chunk_key_pos;
+        for (const auto i : algo::range(chunk_size))
+            chunk_ptr[i] ^= chunk_key_ptr[i];
+        offset += chunk_size;
+        chunk_key_pos = 0;
+    }
+}
+
+void algo::crypt::xor_repeating(
+    bstr &data, const bstr &key, const size_t key_pos)
+{
+    xor_repeating(
+        data.get<u8>(), data.size(), key.get<const u8>(), key.size(), key_pos);
+}
+
+u8 algo::crypt::xor_incrementing(
+    u8 *data, const size_t size, const u8 key, const u8 step)
+{
+    for (const auto i : algo::range(size))
+        data[i] ^= static_cast<u8>(key + i * step);
+    return key + size * step;
+}
+
+u8 algo::crypt::xor_incrementing_reverse_interleaved(
+    const u8 *input,
+    u8 *output,
+    const size_t size,
+    u8 key,
+    const u8 step)
+{
+    for (const auto j : algo::range(2))
+    {
+        if (size <= static_cast<size_t>(j))
+            break;
+        const auto count = (size - j + 1) >> 1;
+        const auto last = size - j - 1;
+        for (const auto i : algo::range(count))
+            output[last - 2 * i] = input[i] ^ static_cast<u8>(key + i * step);
+        input += count;
+        key += count * step;
+    }
+    return key;
+}
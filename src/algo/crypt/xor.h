@@ -0,0 +1,58 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include "types.h"
+
+namespace au {
+namespace algo {
+namespace crypt {
+
+    // In-place kernels for the simple XOR ciphers found in many archives.
+    // They work on raw buffers, and their inner loops carry no dependency
+    // from one byte to the next so that the compiler can vectorize them.
+
+    // data[i] ^= key
+    void xor_constant(u8 *data, const size_t size, const u8 key);
+
+    // data[i] ^= key[(key_pos + i) % key_size]
+    void xor_repeating(
+        u8 *data,
+        const size_t size,
+        const u8 *key,
+        const size_t key_size,
+        const size_t key_pos = 0);
+
+    void xor_repeating(bstr &data, const bstr &key, const size_t key_pos = 0);
+
+    // data[i] ^= key + i * step; returns the key for the next byte.
+    u8 xor_incrementing(
+        u8 *data, const size_t size, const u8 key, const u8 step);
+
+    // XORs input with an incrementing key like xor_incrementing, storing
+    // the first half of the result in every other byte of output going
+    // backwards from its end, and the second half in the bytes between
+    // them. Returns the key for the next byte.
+    u8 xor_incrementing_reverse_interleaved(
+        const u8 *input,
+        u8 *output,
+        const size_t size,
+        const u8 key,
+        const u8 step);
+
+} } }
@@ -0,0 +1,86 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#include "algo/key_trial.h"
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include "algo/range.h"
+
+using namespace au;
+
+static bool run_trial(
+    const std::function<bool(const size_t)> &trial, const size_t index)
+{
+    try
+    {
+        return trial(index);
+    }
+    catch (...)
+    {
+        return false;
+    }
+}
+
+size_t algo::find_first_match(
+    const size_t candidate_count,
+    const std::function<bool(const size_t)> &trial,
+    const size_t max_threads)
+{
+    const auto thread_count = std::min<size_t>(
+        candidate_count,
+        max_threads
+            ? max_threads
+            : std::max<size_t>(1, std::thread::hardware_concurrency()));
+
+    if (thread_count <= 1)
+    {
+        for (const auto i : algo::range(candidate_count))
+            if (run_trial(trial, i))
+                return i;
+        return candidate_count;
+    }
+
+    std::atomic<size_t> next_index(0);
+    std::atomic<size_t> best_index(candidate_count);
+
+    const auto work = [&]()
+    {
+        while (true)
+        {
+            const auto index = next_index++;
+            if (index >= best_index)
+                return;
+            if (!run_trial(trial, index))
+                continue;
+            auto current = best_index.load();
+            while (index < current
+                && !best_index.compare_exchange_weak(current, index))
+            {
+            }
+            return;
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (const auto i : algo::range(thread_count - 1))
+        threads.emplace_back(work);
+    work();
+    for (auto &thread : threads)
+        thread.join();
+    return best_index;
+}
@@ -0,0 +1,55 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <functional>
+#include <vector>
+#include "types.h"
+
+namespace au {
+namespace algo {
+
+    // Runs trial(i) for candidates 0..candidate_count-1, spread across up
+    // to max_threads threads (0 = one per core), and returns the lowest
+    // index for which it returned true, or candidate_count if none did.
+    // A trial that throws counts as a miss. Candidates are handed out in
+    // order and those past an already found hit are never started, so the
+    // result is the same as that of a serial search.
+    //
+    // Expensive per-key state (key schedules, parsed plugin data) should
+    // be built once beforehand and only looked up by index here. For
+    // trials that take microseconds, pass max_threads = 1; starting
+    // threads would cost more than it saves.
+    size_t find_first_match(
+        const size_t candidate_count,
+        const std::function<bool(const size_t)> &trial,
+        const size_t max_threads = 0);
+
+    template<typename T, typename F> const T *find_first_match(
+        const std::vector<T> &candidates,
+        const F &trial,
+        const size_t max_threads = 0)
+    {
+        const auto index = find_first_match(
+            candidates.size(),
+            [&](const size_t i) { return trial(candidates[i]); },
+            max_threads);
+        return index < candidates.size() ? &candidates[index] : nullptr;
+    }
+
+} }
@@ -0,0 +1,301 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#include "api.h"
+#include <algorithm>
+#include <mutex>
+#include "dec/base_archive_decoder.h"
+#include "dec/idecoder_visitor.h"
+#include "dec/registry.h"
+#include "err.h"
+#include "flow/decoder_pool.h"
+#include "flow/file_saver_callback.h"
+#include "flow/journal.h"
+#include "flow/parallel_unpacker.h"
+#include "flow/path_filter.h"
+#include "io/file_system.h"
+#include "logger.h"
+#include "virtual_file_system.h"
+
+using namespace au;
+using namespace au::api;
+
+namespace
+{
+    struct ArchiveDecoderExtractor final : public dec::IDecoderVisitor
+    {
+        void visit(const dec::BaseArchiveDecoder &decoder) override
+        {
+            archive_decoder = &decoder;
+        }
+
+        void visit(const dec::BaseFileDecoder &decoder) override {}
+        void visit(const dec::BaseImageDecoder &decoder) override {}
+        void visit(const dec::BaseAudioDecoder &decoder) override {}
+
+        const dec::BaseArchiveDecoder *archive_decoder = nullptr;
+    };
+
+    // Lets decoders find companion files next to an input for as long as
+    // it's alive.
+    class DirectoryRegistration final
+    {
+    public:
+        DirectoryRegistration(const io::path &path) : path(path)
+        {
+            VirtualFileSystem::register_directory(path);
+        }
+
+        ~DirectoryRegistration()
+        {
+            VirtualFileSystem::unregister_directory(path);
+        }
+
+    private:
+        io::path path;
+    };
+}
+
+static Logger make_logger(const Options &options)
+{
+    Logger logger;
+    if (!options.verbose)
+        logger.mute();
+    return logger;
+}
+
+static std::set<std::string> get_decoders_to_check(const Options &options)
+{
+    if (!options.decoder_name.empty())
+        return {options.decoder_name};
+    const auto names = dec::Registry::instance().get_decoder_names();
+    return std::set<std::string>(names.begin(), names.end());
+}
+
+struct Archive::Priv final
+{
+    Priv(
+        std::unique_ptr<DirectoryRegistration> directory_registration,
+        std::unique_ptr<io::File> input_file,
+        const Options &options);
+
+    std::unique_ptr<io::File> read_entry(const size_t index);
+
+    std::unique_ptr<DirectoryRegistration> directory_registration;
+    Logger logger;
+    flow::DecoderPool decoder_pool;
+    std::unique_ptr<io::File> input_file;
+    std::string decoder_name;
+    std::shared_ptr<dec::IDecoder> decoder;
+    const dec::BaseArchiveDecoder *archive_decoder;
+    std::unique_ptr<dec::ArchiveMeta> meta;
+    std::vector<Entry> entries;
+    std::mutex mutex;
+};
+
+Archive::Priv::Priv(
+    std::unique_ptr<DirectoryRegistration> directory_registration,
+    std::unique_ptr<io::File> input_file,
+    const Options &options) :
+        directory_registration(std::move(directory_registration)),
+        logger(make_logger(options)),
+        decoder_pool(dec::Registry::instance(), options.arguments),
+        input_file(std::move(input_file))
+{
+    for (const auto &name : get_decoders_to_check(options))
+    {
+        const auto recognizer = decoder_pool.get_recognizer(name);
+        ArchiveDecoderExtractor extractor;
+        recognizer->accept(extractor);
+        if (!extractor.archive_decoder
+            || !recognizer->is_recognized(*this->input_file))
+        {
+            continue;
+        }
+        if (!decoder_name.empty())
+        {
+            throw err::RecognitionError(
+                "File was recognized by multiple decoders");
+        }
+        decoder_name = name;
+    }
+    if (decoder_name.empty())
+        throw err::RecognitionError("File is not a supported archive");
+
+    decoder = decoder_pool.get_decoder(decoder_name);
+    ArchiveDecoderExtractor extractor;
+    decoder->accept(extractor);
+    archive_decoder = extractor.archive_decoder;
+    meta = archive_decoder->read_meta(logger, *this->input_file);
+
+    for (const auto &archive_entry : meta->entries)
+    {
+        Entry entry;
+        entry.path = archive_entry->path;
+        entry.offset = 0;
+        entry.size = 0;
+        entry.compressed_size = 0;
+        if (const auto plain_entry
+            = dynamic_cast<const dec::PlainArchiveEntry*>(archive_entry.get()))
+        {
+            entry.offset = plain_entry->offset;
+            entry.size = plain_entry->size;
+            entry.compressed_size = plain_entry->size;
+        }
+        else if (const auto compressed_entry
+            = dynamic_cast<const dec::CompressedArchiveEntry*>(
+                archive_entry.get()))
+        {
+            entry.offset = compressed_entry->offset;
+            entry.size = compressed_entry->size_orig;
+            entry.compressed_size = compressed_entry->size_comp;
+        }
+        entries.push_back(entry);
+    }
+}
+
+std::unique_ptr<io::File> Archive::Priv::read_entry(const size_t index)
+{
+    if (index >= meta->entries.size())
+        throw err::UsageError("Entry index out of range");
+    // entries share the input stream
+    std::unique_lock<std::mutex> lock(mutex);
+    auto output_file = archive_decoder->read_file(
+        logger, *input_file, *meta, *meta->entries[index]);
+    if (!output_file)
+        throw err::CorruptDataError("Entry has no data");
+    return output_file;
+}
+
+Archive::Archive(const io::path &path, const Options &options)
+{
+    auto directory_registration = std::make_unique<DirectoryRegistration>(
+        io::absolute(path).parent());
+    p.reset(new Priv(
+        std::move(directory_registration),
+        std::make_unique<io::File>(path, io::FileMode::Read),
+        options));
+}
+
+Archive::Archive(
+    const io::path &name, const bstr &data, const Options &options)
+    : p(new Priv(nullptr, std::make_unique<io::File>(name, data), options))
+{
+}
+
+Archive::~Archive()
+{
+}
+
+std::string Archive::get_decoder_name() const
+{
+    return p->decoder_name;
+}
+
+const std::vector<Entry> &Archive::get_entries() const
+{
+    return p->entries;
+}
+
+bstr Archive::read_entry(const size_t index) const
+{
+    return p->read_entry(index)->stream.seek(0).read_to_eof();
+}
+
+void Archive::read_entry(const size_t index, std::ostream &output) const
+{
+    const auto data = read_entry(index);
+    output.write(data.get<char>(), data.size());
+}
+
+size_t Archive::read_entry(
+    const size_t index, u8 *buffer, const size_t buffer_size) const
+{
+    const auto data = read_entry(index);
+    std::copy(
+        data.get<u8>(),
+        data.get<u8>() + std::min(data.size(), buffer_size),
+        buffer);
+    return data.size();
+}
+
+static bool unpack_inputs(
+    const std::vector<std::pair<io::path, flow::InputFileFactory>> &inputs,
+    const OutputCallback &callback,
+    const Options &options)
+{
+    const auto logger = make_logger(options);
+    const flow::FileSaverCallback file_saver(
+        [&](std::shared_ptr<io::File> file)
+        {
+            callback(file->path, file->stream.seek(0).read_to_eof());
+        });
+    const flow::PathFilter path_filter;
+    flow::Journal journal;
+    const flow::ParallelUnpackerContext context(
+        logger,
+        file_saver,
+        dec::Registry::instance(),
+        path_filter,
+        journal,
+        options.enable_nested_decoding,
+        options.arguments,
+        get_decoders_to_check(options));
+
+    flow::ParallelUnpacker unpacker(context);
+    for (const auto &input : inputs)
+        unpacker.add_input_file(input.first, input.second);
+    return unpacker.run(options.thread_count);
+}
+
+bool api::unpack(
+    const std::vector<io::path> &input_paths,
+    const OutputCallback &callback,
+    const Options &options)
+{
+    std::vector<std::unique_ptr<DirectoryRegistration>> registrations;
+    std::vector<std::pair<io::path, flow::InputFileFactory>> inputs;
+    for (const auto &input_path : input_paths)
+    {
+        registrations.push_back(std::make_unique<DirectoryRegistration>(
+            io::absolute(input_path).parent()));
+        inputs.push_back(std::make_pair(
+            io::path(input_path).change_stem(input_path.stem() + "~").name(),
+            [=]()
+            {
+                return std::make_shared<io::File>(
+                    io::absolute(input_path), io::FileMode::Read);
+            }));
+    }
+    return unpack_inputs(inputs, callback, options);
+}
+
+bool api::unpack(
+    const io::path &name,
+    const bstr &data,
+    const OutputCallback &callback,
+    const Options &options)
+{
+    std::vector<std::pair<io::path, flow::InputFileFactory>> inputs;
+    inputs.push_back(std::make_pair(
+        io::path(name).change_stem(name.stem() + "~").name(),
+        [=]()
+        {
+            return std::make_shared<io::File>(name, data);
+        }));
+    return unpack_inputs(inputs, callback, options);
+}
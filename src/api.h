@@ -0,0 +1,108 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "io/path.h"
+#include "types.h"
+
+namespace au {
+namespace api {
+
+    // Entry point for embedding arc_unpacker without going through the
+    // command line. Nothing here writes to the disk; all outputs are handed
+    // back to the caller.
+
+    struct Options final
+    {
+        // Empty for automatic detection.
+        std::string decoder_name;
+
+        // Decoder switches as given on the command line, e.g. --plugin=...
+        std::vector<std::string> arguments;
+
+        // Whether to decode files found inside archives (images, nested
+        // archives...) during bulk unpacking.
+        bool enable_nested_decoding = true;
+
+        // 0 uses one thread per core.
+        size_t thread_count = 0;
+
+        // Whether to print progress to the console.
+        bool verbose = false;
+    };
+
+    struct Entry final
+    {
+        io::path path;
+
+        // Zero when the decoder doesn't store entry sizes in the index.
+        uoff_t offset;
+        size_t size;
+        size_t compressed_size;
+    };
+
+    class Archive final
+    {
+    public:
+        // Both throw if the input isn't recognized as an archive.
+        Archive(const io::path &path, const Options &options = Options());
+        Archive(
+            const io::path &name,
+            const bstr &data,
+            const Options &options = Options());
+        ~Archive();
+
+        std::string get_decoder_name() const;
+        const std::vector<Entry> &get_entries() const;
+
+        bstr read_entry(const size_t index) const;
+        void read_entry(const size_t index, std::ostream &output) const;
+
+        // Copies at most buffer_size bytes and returns the full entry size,
+        // so that callers can retry with a bigger buffer.
+        size_t read_entry(
+            const size_t index, u8 *buffer, const size_t buffer_size) const;
+
+    private:
+        struct Priv;
+        std::unique_ptr<Priv> p;
+    };
+
+    // Called with the final output path and contents. Calls are serialized,
+    // but may come from any of the worker threads.
+    using OutputCallback
+        = std::function<void(const io::path &path, const bstr &data)>;
+
+    // Return whether all inputs were unpacked without errors.
+    bool unpack(
+        const std::vector<io::path> &input_paths,
+        const OutputCallback &callback,
+        const Options &options = Options());
+
+    bool unpack(
+        const io::path &name,
+        const bstr &data,
+        const OutputCallback &callback,
+        const Options &options = Options());
+
+} }
@@ -57,6 +57,7 @@ namespace
 
         std::string value_name;
         std::string value;
+        std::vector<std::string> values;
         std::vector<std::pair<std::string, std::string>> possible_values;
         bool possible_values_hidden;
     };
@@ -339,6 +340,7 @@ void ArgParser::Priv::parse_single_arg(const std::string &arg)
 
         sw->is_set = true;
         sw->value = value;
+        sw->values.push_back(value);
         return;
     }
 }
@@ -394,6 +396,15 @@ const std::string ArgParser::get_switch(const std::string &name) const
     throw std::logic_error("Trying to use undefined switch \"" + name + "\"");
 }
 
+const std::vector<std::string> ArgParser::get_switches(
+    const std::string &name) const
+{
+    for (const auto &sw : p->switches)
+        if (sw->has_name(name))
+            return sw->values;
+    throw std::logic_error("Trying to use undefined switch \"" + name + "\"");
+}
+
 bool ArgParser::has_flag(const std::string &name) const
 {
     for (const auto &f : p->flags)
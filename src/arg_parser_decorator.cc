@@ -21,8 +21,11 @@ using namespace au;
 
 ArgParserDecorator::ArgParserDecorator(
     const std::function<void(ArgParser &)> register_callback,
-    const std::function<void(const ArgParser &)> parse_callback)
-    : register_callback(register_callback), parse_callback(parse_callback)
+    const std::function<void(const ArgParser &)> parse_callback,
+    const BasePluginManager *plugin_manager)
+    : register_callback(register_callback),
+        parse_callback(parse_callback),
+        plugin_manager(plugin_manager)
 {
 }
 
@@ -35,3 +38,8 @@ void ArgParserDecorator::parse_cli_options(const ArgParser &arg_parser) const
 {
     parse_callback(arg_parser);
 }
+
+const BasePluginManager *ArgParserDecorator::get_plugin_manager() const
+{
+    return plugin_manager;
+}
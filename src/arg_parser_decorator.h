@@ -21,20 +21,27 @@
 
 namespace au {
 
+    class BasePluginManager;
+
     class ArgParserDecorator final
     {
     public:
         ArgParserDecorator(
             const std::function<void(ArgParser &)> register_callback,
-            const std::function<void(const ArgParser &)> parse_callback);
+            const std::function<void(const ArgParser &)> parse_callback,
+            const BasePluginManager *plugin_manager = nullptr);
 
         void register_cli_options(ArgParser &arg_parser) const;
 
         void parse_cli_options(const ArgParser &arg_parser) const;
 
+        // The plugin manager whose option this decorator registers, if any.
+        const BasePluginManager *get_plugin_manager() const;
+
     private:
         std::function<void(ArgParser &)> register_callback;
         std::function<void(const ArgParser &)> parse_callback;
+        const BasePluginManager *plugin_manager;
     };
 
 }
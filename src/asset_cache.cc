@@ -0,0 +1,110 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#include "asset_cache.h"
+#include <future>
+#include <map>
+#include <mutex>
+#include <set>
+#include "algo/format.h"
+#include "io/file.h"
+#include "io/file_system.h"
+#include "io/program_path.h"
+
+using namespace au;
+
+using Value = std::shared_ptr<const void>;
+
+static std::mutex mutex;
+static std::map<std::string, std::shared_future<Value>> values;
+static std::set<std::string> transient_keys;
+
+bstr AssetCache::read_asset(const io::path &relative_path)
+{
+    return *get<bstr>(
+        "asset:" + relative_path.str(),
+        [&]()
+        {
+            io::File file(
+                io::get_assets_dir_path() / relative_path, io::FileMode::Read);
+            return std::make_shared<const bstr>(
+                file.stream.seek(0).read_to_eof());
+        });
+}
+
+std::string AssetCache::identify_file(const io::path &path)
+{
+    return algo::format(
+        "%s\t%llu\t%lld",
+        io::absolute(path).c_str(),
+        static_cast<unsigned long long>(io::file_size(path)),
+        static_cast<long long>(io::last_write_time(path)));
+}
+
+void AssetCache::clear()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    values.clear();
+    transient_keys.clear();
+}
+
+void AssetCache::clear_transient()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    for (const auto &key : transient_keys)
+        values.erase(key);
+    transient_keys.clear();
+}
+
+Value AssetCache::get_impl(
+    const std::string &key,
+    const std::function<Value()> &factory,
+    const bool transient)
+{
+    std::promise<Value> promise;
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        const auto it = values.find(key);
+        if (it != values.end())
+        {
+            const auto future = it->second;
+            lock.unlock();
+            return future.get();
+        }
+        values[key] = promise.get_future().share();
+        if (transient)
+            transient_keys.insert(key);
+    }
+
+    // the factory runs unlocked, since it might use the cache itself
+    try
+    {
+        const auto value = factory();
+        promise.set_value(value);
+        return value;
+    }
+    catch (...)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            values.erase(key);
+            transient_keys.erase(key);
+        }
+        promise.set_exception(std::current_exception());
+        throw;
+    }
+}
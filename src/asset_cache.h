@@ -0,0 +1,78 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <typeinfo>
+#include "io/path.h"
+#include "types.h"
+
+namespace au {
+
+    // Process-wide store for things that are costly to produce but never
+    // change during a run, such as files from the assets directory,
+    // plugin objects built from them, or key material found next to the
+    // input archives. Each key is produced at most once even if several
+    // threads ask for it at the same time; failures aren't cached.
+    class AssetCache final
+    {
+    public:
+        // Reads a file relative to the assets directory.
+        static bstr read_asset(const io::path &relative_path);
+
+        // Identifies a file on disk by its path, size and modification
+        // time, for keys of values derived from its contents, so that
+        // long-running hosts such as the daemon notice when it changes.
+        static std::string identify_file(const io::path &path);
+
+        template<typename T> static std::shared_ptr<const T> get(
+            const std::string &key,
+            const std::function<std::shared_ptr<const T>()> &factory)
+        {
+            return std::static_pointer_cast<const T>(get_impl(
+                std::string(typeid(T).name()) + ":" + key,
+                [&]() -> std::shared_ptr<const void> { return factory(); },
+                false));
+        }
+
+        // Like get(), for values that can't be keyed by identify_file(),
+        // such as the results of searching a game directory. These are
+        // dropped by clear_transient().
+        template<typename T> static std::shared_ptr<const T> get_transient(
+            const std::string &key,
+            const std::function<std::shared_ptr<const T>()> &factory)
+        {
+            return std::static_pointer_cast<const T>(get_impl(
+                std::string(typeid(T).name()) + ":" + key,
+                [&]() -> std::shared_ptr<const void> { return factory(); },
+                true));
+        }
+
+        static void clear();
+        static void clear_transient();
+
+    private:
+        static std::shared_ptr<const void> get_impl(
+            const std::string &key,
+            const std::function<std::shared_ptr<const void>()> &factory,
+            const bool transient);
+    };
+
+}
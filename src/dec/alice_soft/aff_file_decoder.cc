@@ -16,7 +16,7 @@
 // along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
 
 #include "dec/alice_soft/aff_file_decoder.h"
-#include "algo/range.h"
+#include "algo/crypt/xor.h"
 
 // Doesn't encode anything, just wraps real files.
 
@@ -40,8 +40,11 @@ std::unique_ptr<io::File> AffFileDecoder::decode_impl(
     input_file.stream.skip(4);
 
     auto data = input_file.stream.read_to_eof();
-    for (const auto i : algo::range(std::min<size_t>(data.size(), 64)))
-        data[i] ^= key[i % key.size()];
+    algo::crypt::xor_repeating(
+        data.get<u8>(),
+        std::min<size_t>(data.size(), 64),
+        key.get<const u8>(),
+        key.size());
     auto output_file = std::make_unique<io::File>(input_file.path, data);
     output_file->guess_extension();
     return output_file;
@@ -19,7 +19,7 @@
 #include "algo/pack/zlib.h"
 #include "algo/range.h"
 #include "err.h"
-#include "io/memory_byte_stream.h"
+#include "res/image_kernels.h"
 
 using namespace au;
 using namespace au::dec::alice_soft;
@@ -38,95 +38,39 @@ namespace
 
 static void deinterleave(res::Image &image, const bstr &input)
 {
-    io::MemoryByteStream input_stream(input);
-
-    size_t x, y;
-    for (const auto i : algo::range(3))
+    const auto *input_ptr = input.get<const u8>();
+    auto input_size = input.size();
+    for (const auto c : algo::range(3))
     {
-        for (y = 0; y < image.height() - 1; y += 2)
-        {
-            for (x = 0; x < image.width() - 1; x += 2)
-            {
-                image.at(x, y)[i] = input_stream.read<u8>();
-                image.at(x, y + 1)[i] = input_stream.read<u8>();
-                image.at(x + 1, y)[i] = input_stream.read<u8>();
-                image.at(x + 1, y + 1)[i] = input_stream.read<u8>();
-            }
-            if (x != image.width())
-            {
-                image.at(x, y)[i] = input_stream.read<u8>();
-                image.at(x, y + 1)[i] = input_stream.read<u8>();
-                input_stream.skip(2);
-            }
-        }
-        if (y != image.height())
-        {
-            for (x = 0; x < image.width() - 1; x += 2)
-            {
-                image.at(x, y)[i] = input_stream.read<u8>();
-                input_stream.skip(1);
-                image.at(x + 1, y)[i] = input_stream.read<u8>();
-                input_stream.skip(1);
-            }
-            if (x != image.width())
-            {
-                image.at(x, y)[i] = input_stream.read<u8>();
-                input_stream.skip(3);
-            }
-        }
+        const auto size = res::scatter_channel_blocks_2x2(
+            image, c, input_ptr, input_size);
+        input_ptr += size;
+        input_size -= size;
     }
 }
 
 static void apply_differences(res::Image &image)
 {
-    for (const auto x : algo::range(1, image.width()))
-    for (const auto c : algo::range(3))
-        image.at(x, 0)[c] = image.at(x - 1, 0)[c] - image.at(x, 0)[c];
-
-    for (const auto y : algo::range(1, image.height()))
-    for (const auto c : algo::range(3))
-        image.at(0, y)[c] = image.at(0, y - 1)[c] - image.at(0, y)[c];
-
-    for (const auto y : algo::range(1, image.height()))
-    for (const auto x : algo::range(1, image.width()))
     for (const auto c : algo::range(3))
-    {
-        u8 ax = image.at(x - 1, y)[c];
-        u8 ay = image.at(x, y - 1)[c];
-        image.at(x, y)[c] = (ax + ay) / 2 - image.at(x, y)[c];
-    }
+        res::apply_average_delta(image, c, res::DeltaKind::Subtract);
 }
 
 static void apply_alpha(res::Image &image, const bstr &input)
 {
     if (!input.size())
     {
-        for (const auto y : algo::range(image.height()))
-        for (const auto x : algo::range(image.width()))
-            image.at(x, y).a = 0xFF;
+        res::fill_channel(image, 3, 0xFF);
         return;
     }
 
-    io::MemoryByteStream input_stream(input);
-
-    image.at(0, 0).a = input_stream.read<u8>();
-    for (const auto x : algo::range(1, image.width()))
-        image.at(x, 0).a = image.at(x - 1, 0).a - input_stream.read<u8>();
-    if (image.width() & 1)
-        input_stream.skip(1);
-
-    for (const auto y : algo::range(1, image.height()))
-    {
-        image.at(0, y).a = image.at(0, y - 1).a - input_stream.read<u8>();
-        for (const auto x : algo::range(1, image.width()))
-        {
-            u8 ax = image.at(x - 1, y).a;
-            u8 ay = image.at(x, y - 1).a;
-            image.at(x, y).a = (ax + ay) / 2 - input_stream.read<u8>();
-        }
-        if (image.width() & 1)
-            input_stream.skip(1);
-    }
+    // rows are padded to even width
+    res::scatter_channel(
+        image,
+        3,
+        input.get<const u8>(),
+        input.size(),
+        (image.width() + 1) & ~1);
+    res::apply_average_delta(image, 3, res::DeltaKind::Subtract);
 }
 
 bool QntImageDecoder::is_recognized_impl(io::File &input_file) const
@@ -0,0 +1,100 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#include "dec/archive_meta_cache.h"
+#include <mutex>
+#include "algo/crypt/sha1.h"
+#include "algo/format.h"
+#include "algo/str.h"
+#include "io/file_byte_stream.h"
+#include "io/file_system.h"
+
+using namespace au;
+using namespace au::dec;
+
+// bump whenever the serialized form of any decoder changes
+static const auto cache_version = 1;
+
+static std::mutex mutex;
+static io::path cache_dir;
+static bool enabled = false;
+
+static io::path get_cache_path(const std::string &key)
+{
+    return cache_dir / algo::hex(algo::crypt::sha1(key));
+}
+
+void ArchiveMetaCache::enable(const io::path &dir)
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    io::create_directories(dir);
+    cache_dir = dir;
+    enabled = true;
+}
+
+void ArchiveMetaCache::disable()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    enabled = false;
+}
+
+bool ArchiveMetaCache::is_enabled()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    return enabled;
+}
+
+std::string ArchiveMetaCache::make_key(
+    const io::File &input_file, const std::string &decoder_id)
+{
+    // nested files live in memory and have relative paths
+    const auto &path = input_file.path;
+    if (!path.is_absolute() || !io::is_regular_file(path))
+        return "";
+    if (io::file_size(path) != input_file.stream.size())
+        return "";
+    return algo::format(
+        "%d\n%s\n%s\n%llu\n%lld",
+        cache_version,
+        decoder_id.c_str(),
+        path.c_str(),
+        static_cast<unsigned long long>(input_file.stream.size()),
+        static_cast<long long>(io::last_write_time(path)));
+}
+
+bstr ArchiveMetaCache::load(const std::string &key)
+{
+    if (!is_enabled() || key.empty())
+        return ""_b;
+    const auto path = get_cache_path(key);
+    if (!io::exists(path))
+        return ""_b;
+    io::FileByteStream input_stream(path, io::FileMode::Read);
+    if (input_stream.read_to_zero().str() != key)
+        return ""_b;
+    return input_stream.read_to_eof();
+}
+
+void ArchiveMetaCache::store(const std::string &key, const bstr &data)
+{
+    if (!is_enabled() || key.empty())
+        return;
+    io::FileByteStream output_stream(get_cache_path(key), io::FileMode::Write);
+    output_stream.write(key);
+    output_stream.write<u8>(0);
+    output_stream.write(data);
+}
@@ -0,0 +1,44 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <string>
+#include "io/file.h"
+#include "io/path.h"
+
+namespace au {
+namespace dec {
+
+    // Persistent store for serialized archive metadata, so that archives
+    // don't have to be parsed again on every run. Disabled by default.
+    class ArchiveMetaCache final
+    {
+    public:
+        static void enable(const io::path &cache_dir);
+        static void disable();
+        static bool is_enabled();
+
+        // Returns an empty key for files that don't come from the disk.
+        static std::string make_key(
+            const io::File &input_file, const std::string &decoder_id);
+
+        static bstr load(const std::string &key);
+        static void store(const std::string &key, const bstr &data);
+    };
+
+} }
@@ -18,9 +18,13 @@
 #include "dec/base_archive_decoder.h"
 #include <algorithm>
 #include <cmath>
+#include <typeinfo>
 #include "algo/format.h"
+#include "dec/archive_meta_cache.h"
 #include "dec/idecoder_visitor.h"
 #include "err.h"
+#include "io/memory_byte_stream.h"
+#include "plugin_manager.h"
 
 using namespace au;
 using namespace au::dec;
@@ -57,8 +61,7 @@ void BaseArchiveDecoder::accept(IDecoderVisitor &visitor) const
 std::unique_ptr<ArchiveMeta> BaseArchiveDecoder::read_meta(
     const Logger &logger, io::File &input_file) const
 {
-    input_file.stream.seek(0);
-    auto meta = read_meta_impl(logger, input_file);
+    auto meta = read_meta_cached(logger, input_file);
 
     const auto width = meta->entries.size() > 1
         ? std::max<int>(1, 1 + std::log10(meta->entries.size()))
@@ -100,6 +103,115 @@ std::unique_ptr<ArchiveMeta> BaseArchiveDecoder::read_meta(
     return meta;
 }
 
+std::unique_ptr<ArchiveMeta> BaseArchiveDecoder::read_meta_cached(
+    const Logger &logger, io::File &input_file) const
+{
+    // the cached meta can't be deserialized without knowing the plugin,
+    // and finding it takes parsing the table anyway
+    if (const auto plugin_manager = get_auto_plugin_manager())
+    {
+        input_file.stream.seek(0);
+        return read_meta_detecting_plugin(logger, input_file, *plugin_manager);
+    }
+
+    const auto key = ArchiveMetaCache::is_enabled()
+        ? ArchiveMetaCache::make_key(input_file, typeid(*this).name())
+        : "";
+
+    if (!key.empty())
+    {
+        const auto data = ArchiveMetaCache::load(key);
+        if (!data.empty())
+        {
+            try
+            {
+                io::MemoryByteStream data_stream(data);
+                auto meta = deserialize_meta(input_file, data_stream);
+                if (meta)
+                    return meta;
+            }
+            catch (const std::exception &e)
+            {
+                logger.warn("Ignoring corrupt metadata cache (%s)\n", e.what());
+            }
+        }
+    }
+
+    input_file.stream.seek(0);
+    auto meta = read_meta_impl(logger, input_file);
+
+    if (!key.empty())
+    {
+        io::MemoryByteStream data_stream;
+        if (serialize_meta(*meta, data_stream))
+        {
+            try
+            {
+                ArchiveMetaCache::store(key, data_stream.seek(0).read_to_eof());
+            }
+            catch (const std::exception &e)
+            {
+                logger.warn("Could not update metadata cache (%s)\n", e.what());
+            }
+        }
+    }
+
+    return meta;
+}
+
+const BasePluginManager *BaseArchiveDecoder::get_auto_plugin_manager() const
+{
+    for (const auto &decorator : get_arg_parser_decorators())
+    {
+        const auto plugin_manager = decorator.get_plugin_manager();
+        if (plugin_manager && plugin_manager->is_auto())
+            return plugin_manager;
+    }
+    return nullptr;
+}
+
+std::unique_ptr<ArchiveMeta> BaseArchiveDecoder::read_meta_detecting_plugin(
+    const Logger &logger,
+    io::File &input_file,
+    const BasePluginManager &plugin_manager) const
+{
+    Logger muted_logger(logger);
+    muted_logger.mute();
+    const auto name = plugin_manager.detect([&]()
+    {
+        input_file.stream.seek(0);
+        const auto meta = read_meta_impl(muted_logger, input_file);
+        return meta
+            && !meta->entries.empty()
+            && is_plugin_match(muted_logger, input_file, *meta);
+    });
+    logger.info("Detected plugin: %s\n", name.c_str());
+
+    BasePluginManager::ScopedSelection selection(plugin_manager, name);
+    input_file.stream.seek(0);
+    return read_meta_impl(logger, input_file);
+}
+
+bool BaseArchiveDecoder::serialize_meta(
+    const ArchiveMeta &m, io::BaseByteStream &output_stream) const
+{
+    return false;
+}
+
+std::unique_ptr<ArchiveMeta> BaseArchiveDecoder::deserialize_meta(
+    io::File &input_file, io::BaseByteStream &input_stream) const
+{
+    return nullptr;
+}
+
+bool BaseArchiveDecoder::is_plugin_match(
+    const Logger &logger,
+    io::File &input_file,
+    const ArchiveMeta &meta) const
+{
+    return false;
+}
+
 std::unique_ptr<io::File> BaseArchiveDecoder::read_file(
     const Logger &logger,
     io::File &input_file,
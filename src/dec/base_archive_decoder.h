@@ -79,7 +79,37 @@ namespace dec {
             const ArchiveMeta &m,
             const ArchiveEntry &e) const = 0;
 
+        // Optional support for ArchiveMetaCache, worth implementing for
+        // formats whose tables are costly to parse. serialize_meta returns
+        // false if the meta cannot be cached.
+        virtual bool serialize_meta(
+            const ArchiveMeta &m, io::BaseByteStream &output_stream) const;
+
+        virtual std::unique_ptr<ArchiveMeta> deserialize_meta(
+            io::File &input_file, io::BaseByteStream &input_stream) const;
+
+        // Support for --plugin=auto, for decoders that enable it on their
+        // plugin manager. Called with the plugin being tried selected and
+        // the meta it produced; returns whether the archive contents check
+        // out, e.g. against a checksum. The plugin stays selected only for
+        // read_meta_impl, so read_file_impl must not consult it.
+        virtual bool is_plugin_match(
+            const Logger &logger,
+            io::File &input_file,
+            const ArchiveMeta &meta) const;
+
     private:
+        std::unique_ptr<ArchiveMeta> read_meta_cached(
+            const Logger &logger, io::File &input_file) const;
+
+        const BasePluginManager *get_auto_plugin_manager() const;
+
+        // Handles --plugin=auto by trying every plugin on the input.
+        std::unique_ptr<ArchiveMeta> read_meta_detecting_plugin(
+            const Logger &logger,
+            io::File &input_file,
+            const BasePluginManager &plugin_manager) const;
+
         bool numeric_file_names;
     };
 
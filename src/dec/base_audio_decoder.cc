@@ -22,6 +22,23 @@
 using namespace au;
 using namespace au::dec;
 
+BaseAudioDecoder::BaseAudioDecoder() : force_reencode(false)
+{
+    add_arg_parser_decorator(
+        [](ArgParser &arg_parser)
+        {
+            arg_parser.register_flag({"--force-reencode"})
+                ->set_description(
+                    "Converts nested files to WAV even if they could be "
+                    "saved as they are.");
+        },
+        [&](const ArgParser &arg_parser)
+        {
+            if (arg_parser.has_flag("--force-reencode"))
+                force_reencode = true;
+        });
+}
+
 algo::NamingStrategy BaseAudioDecoder::naming_strategy() const
 {
     return algo::NamingStrategy::FlatSibling;
@@ -39,3 +56,18 @@ res::Audio BaseAudioDecoder::decode(const Logger &logger, io::File &file) const
     file.stream.seek(0);
     return decode_impl(logger, file);
 }
+
+bool BaseAudioDecoder::can_pass_through() const
+{
+    return !force_reencode && is_canonical_format();
+}
+
+std::string BaseAudioDecoder::canonical_extension() const
+{
+    return "wav";
+}
+
+bool BaseAudioDecoder::is_canonical_format() const
+{
+    return false;
+}
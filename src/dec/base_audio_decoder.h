@@ -26,6 +26,7 @@ namespace dec {
     class BaseAudioDecoder : public BaseDecoder
     {
     public:
+        BaseAudioDecoder();
         virtual ~BaseAudioDecoder() {}
 
         algo::NamingStrategy naming_strategy() const override;
@@ -34,9 +35,23 @@ namespace dec {
 
         res::Audio decode(const Logger &logger, io::File &input_file) const;
 
+        // Whether nested input files can be saved as they are rather than
+        // decoded and re-encoded.
+        bool can_pass_through() const;
+
+        // Extension given to files saved as they are, whatever they were
+        // called in the archive, like the encoder does for the others.
+        virtual std::string canonical_extension() const;
+
     protected:
+        // Whether the input is already in the format it would be saved in.
+        virtual bool is_canonical_format() const;
+
         virtual res::Audio decode_impl(
             const Logger &logger, io::File &input_file) const = 0;
+
+    private:
+        bool force_reencode;
     };
 
 } }
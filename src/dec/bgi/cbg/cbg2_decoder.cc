@@ -215,13 +215,14 @@ static u8 get_component(float value)
     return std::max(0.0f, std::min(255.0f, value));
 }
 
-static std::vector<u16> decompress_block(
-    size_t output_size,
+static void decompress_block(
     const bstr &input,
     const Tree &tree1,
-    const Tree &tree2)
+    const Tree &tree2,
+    std::vector<u16> &color_info)
 {
-    std::vector<u16> color_info(output_size, 0);
+    const auto output_size = color_info.size();
+    std::fill(color_info.begin(), color_info.end(), 0);
     io::MsbBitStream bit_stream(input);
 
     int init_value = 0;
@@ -270,8 +271,6 @@ static std::vector<u16> decompress_block(
             }
         }
     }
-
-    return color_info;
 }
 
 static void process_24bit_block(
@@ -411,45 +410,47 @@ std::unique_ptr<res::Image> Cbg2Decoder::decode(
     for (const auto i : algo::range(block_count + 1))
         block_offsets[i] = raw_stream.read_le<u32>();
 
-    bstr bmp_data(pad_width * pad_height * 4);
-    for (const auto i : algo::range(bmp_data.size()))
-        bmp_data.get<u8>()[i] = 0xFF;
+    if (channels != 1 && channels != 3 && channels != 4)
+        throw err::UnsupportedChannelCountError(channels);
 
+    const auto block_size_orig = pad_width * block_dim * (depth == 8 ? 1 : 3);
+    std::vector<std::pair<uoff_t, size_t>> block_spans(block_count);
     for (const auto i : algo::range(block_count))
     {
         raw_stream.seek(block_offsets[i]);
         raw_stream.skip((pad_width + block_dim2 - 1) / block_dim2);
-        const auto block_size_orig = read_variable_data(raw_stream);
+        if (read_variable_data(raw_stream) != block_size_orig)
+            throw err::BadDataSizeError();
         int block_size_comp = block_offsets[i + 1] - raw_stream.pos();
         if (block_size_comp < 0)
             block_size_comp = raw_stream.size() - raw_stream.pos();
-        const auto expected_width
-            = pad_width * block_dim * (depth == 8 ? 1 : 3);
-        if (expected_width != block_size_orig)
-            throw err::BadDataSizeError();
+        block_spans[i] = std::make_pair(
+            raw_stream.pos(), static_cast<size_t>(block_size_comp));
+    }
 
-        const auto block_data = raw_stream.read(block_size_comp);
-        const auto color_info = decompress_block(
-            block_size_orig, block_data, tree1, tree2);
+    bstr bmp_data(pad_width * pad_height * 4, 0xFF);
 
-        if (channels == 3 || channels == 4)
-        {
-            process_24bit_block(
-                color_info,
-                ac_mul_pair,
-                pad_width,
-                &bmp_data.get<u8>()[pad_width * block_dim * 4 * i]);
-        }
-        else if (channels == 1)
+    // Decoders already run on the unpacker's worker threads, so rows are
+    // decoded in order, reusing a single coefficient buffer.
+    std::vector<u16> color_info(block_size_orig);
+    for (const auto i : algo::range(block_count))
+    {
+        const auto block_data = raw_stream
+            .seek(block_spans[i].first)
+            .read(block_spans[i].second);
+        decompress_block(block_data, tree1, tree2, color_info);
+        const auto output_ptr
+            = bmp_data.get<u8>() + pad_width * block_dim * 4 * i;
+        if (channels == 1)
         {
             process_8bit_block(
-                color_info,
-                ac_mul_pair,
-                pad_width,
-                &bmp_data.get<u8>()[pad_width * block_dim * 4 * i]);
+                color_info, ac_mul_pair, pad_width, output_ptr);
         }
         else
-            throw err::UnsupportedChannelCountError(channels);
+        {
+            process_24bit_block(
+                color_info, ac_mul_pair, pad_width, output_ptr);
+        }
     }
 
     if (channels == 4)
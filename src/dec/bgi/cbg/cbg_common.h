@@ -17,7 +17,7 @@
 
 #pragma once
 
-#include <memory>
+#include <vector>
 #include "io/base_bit_stream.h"
 #include "io/base_byte_stream.h"
 #include "types.h"
@@ -45,7 +45,7 @@ namespace cbg {
         NodeInfo &operator[](size_t);
 
         u32 size;
-        std::vector<std::shared_ptr<NodeInfo>> nodes;
+        std::vector<NodeInfo> nodes;
     };
 
     u32 read_variable_data(io::BaseByteStream &input_stream);
@@ -36,7 +36,7 @@ namespace
         u32 children[2];
     };
 
-    using NodeList = std::vector<std::unique_ptr<NodeInfo>>;
+    using NodeList = std::vector<NodeInfo>;
 }
 
 static const bstr magic = "DSC FORMAT 1.00\x00"_b;
@@ -56,14 +56,7 @@ static int is_image(const bstr &input)
 
 static NodeList get_nodes(io::BaseByteStream &input_stream, u32 key)
 {
-    NodeList nodes;
-    for (const auto i : algo::range(1024))
-    {
-        auto node_info = std::make_unique<NodeInfo>();
-        node_info->has_children = false;
-        node_info->value = 0;
-        nodes.push_back(std::move(node_info));
-    }
+    NodeList nodes(1024);
 
     std::vector<u32> arr0;
     for (const auto n : algo::range(512))
@@ -90,9 +83,9 @@ static NodeList get_nodes(io::BaseByteStream &input_stream, u32 key)
             const u32 c = arr0_pos < arr0.size() ? arr0[arr0_pos] : 0;
             if (n != (c >> 16))
                 break;
-            nodes[*node_ptr]->has_children = false;
-            nodes[*node_ptr]->look_behind = (arr0[arr0_pos] & 0x100) != 0;
-            nodes[*node_ptr]->value = arr0[arr0_pos] & 0xFF;
+            nodes[*node_ptr].has_children = false;
+            nodes[*node_ptr].look_behind = (arr0[arr0_pos] & 0x100) != 0;
+            nodes[*node_ptr].value = arr0[arr0_pos] & 0xFF;
             arr0_pos++;
             node_ptr++;
             group_count++;
@@ -104,9 +97,9 @@ static NodeList get_nodes(io::BaseByteStream &input_stream, u32 key)
             unk1 = unk1 - group_count;
             for (const auto i : algo::range(unk1))
             {
-                nodes[*node_ptr]->has_children = true;
+                nodes[*node_ptr].has_children = true;
                 for (const auto j : algo::range(2))
-                    *arr1_ptr++ = nodes[*node_ptr]->children[j] = node_index++;
+                    *arr1_ptr++ = nodes[*node_ptr].children[j] = node_index++;
                 node_ptr++;
             }
         }
@@ -131,14 +124,14 @@ static bstr decompress(
     u32 bits = 0, bit_count = 0;
     while (output_ptr < output_end)
     {
-        u32 node_index = 0;
-        while (nodes[node_index]->has_children)
-            node_index = nodes[node_index]->children[bit_stream.read(1)];
+        const NodeInfo *node = &nodes[0];
+        while (node->has_children)
+            node = &nodes[node->children[bit_stream.read(1)]];
 
-        if (nodes[node_index]->look_behind)
+        if (node->look_behind)
         {
             auto offset = bit_stream.read(12);
-            size_t repetitions = nodes[node_index]->value + 2;
+            size_t repetitions = node->value + 2;
             u8 *look_behind = output_ptr - offset - 2;
             if (look_behind < output_start)
                 break;
@@ -149,7 +142,7 @@ static bstr decompress(
         }
         else
         {
-            *output_ptr++ = nodes[node_index]->value;
+            *output_ptr++ = node->value;
         }
     }
 
@@ -170,8 +163,7 @@ std::unique_ptr<io::File> DscFileDecoder::decode_impl(
     input_file.stream.skip(8);
 
     const auto nodes = get_nodes(input_file.stream, key);
-    const auto data = decompress(
-        input_file.stream, std::move(nodes), output_size);
+    const auto data = decompress(input_file.stream, nodes, output_size);
 
     if (is_image(data))
     {
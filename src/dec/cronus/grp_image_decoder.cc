@@ -16,6 +16,7 @@
 // along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
 
 #include "dec/cronus/grp_image_decoder.h"
+#include "algo/key_trial.h"
 #include "algo/pack/lzss.h"
 #include "algo/range.h"
 #include "dec/cronus/common.h"
@@ -144,25 +145,22 @@ GrpImageDecoder::~GrpImageDecoder()
 static std::unique_ptr<Header> read_header(
     const PluginManager<HeaderReader> &plugin_manager, io::File &input_file)
 {
-    for (const auto header_func : plugin_manager.get_all())
-    {
-        input_file.stream.seek(0);
-        try
-        {
-            auto header = header_func(input_file.stream);
-            if (!header)
-                continue;
-            if (!validate_header(*header))
-                continue;
-            header->input_offset = input_file.stream.pos();
-            return header;
-        }
-        catch (...)
+    // Runs for every file during recognition - keep it on this thread.
+    std::unique_ptr<Header> header;
+    algo::find_first_match(
+        plugin_manager.get_all(),
+        [&](const HeaderReader &header_func)
         {
-            continue;
-        }
-    }
-    return nullptr;
+            input_file.stream.seek(0);
+            auto candidate = header_func(input_file.stream);
+            if (!candidate || !validate_header(*candidate))
+                return false;
+            candidate->input_offset = input_file.stream.pos();
+            header = std::move(candidate);
+            return true;
+        },
+        1);
+    return header;
 }
 
 bool GrpImageDecoder::is_recognized_impl(io::File &input_file) const
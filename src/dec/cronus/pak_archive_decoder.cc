@@ -16,6 +16,7 @@
 // along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
 
 #include "dec/cronus/pak_archive_decoder.h"
+#include "algo/key_trial.h"
 #include "algo/pack/lzss.h"
 #include "algo/range.h"
 #include "dec/cronus/common.h"
@@ -99,21 +100,22 @@ std::unique_ptr<dec::ArchiveMeta> PakArchiveDecoder::read_meta_impl(
         input_file.stream.seek(magic3.size());
     const auto encrypted = input_file.stream.read_le<u32>() > 0;
     const auto pos = input_file.stream.pos();
-    for (const auto &plugin : p->plugin_manager.get_all())
-    {
-        input_file.stream.seek(pos);
-        try
-        {
-            auto meta = ::read_meta(input_file, plugin, encrypted);
-            if (meta && meta->entries.size())
-                return meta;
-        }
-        catch (...)
+    std::unique_ptr<dec::ArchiveMeta> meta;
+    algo::find_first_match(
+        p->plugin_manager.get_all(),
+        [&](const Plugin &plugin)
         {
-            continue;
-        }
-    }
-    throw err::RecognitionError("Unknown encryption scheme");
+            input_file.stream.seek(pos);
+            auto candidate = ::read_meta(input_file, plugin, encrypted);
+            if (!candidate || candidate->entries.empty())
+                return false;
+            meta = std::move(candidate);
+            return true;
+        },
+        1);
+    if (!meta)
+        throw err::RecognitionError("Unknown encryption scheme");
+    return meta;
 }
 
 std::unique_ptr<io::File> PakArchiveDecoder::read_file_impl(
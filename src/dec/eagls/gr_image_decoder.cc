@@ -16,6 +16,7 @@
 // along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
 
 #include "dec/eagls/gr_image_decoder.h"
+#include <vector>
 #include "algo/crypt/lcg.h"
 #include "algo/pack/lzss.h"
 #include "algo/range.h"
@@ -56,8 +57,10 @@ res::Image GrImageDecoder::decode_impl(
     const auto seed = input_file.stream.read<u8>() ^ xor_value;
 
     algo::crypt::Lcg lcg(algo::crypt::LcgKind::ParkMillerRevised, seed);
-    for (const auto i : algo::range(0, std::min<size_t>(0x174B, data.size())))
-        data[i] ^= key[lcg.next() % key.size()];
+    std::vector<u32> key_indices(std::min<size_t>(0x174B, data.size()));
+    lcg.fill(key_indices.data(), key_indices.size());
+    for (const auto i : algo::range(key_indices.size()))
+        data[i] ^= key[key_indices[i] % key.size()];
 
     const auto output_size = guess_output_size(data);
     data = algo::pack::lzss_decompress(data, output_size);
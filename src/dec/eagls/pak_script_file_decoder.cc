@@ -16,6 +16,7 @@
 // along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
 
 #include "dec/eagls/pak_script_file_decoder.h"
+#include <vector>
 #include "algo/crypt/lcg.h"
 #include "algo/range.h"
 
@@ -61,8 +62,10 @@ std::unique_ptr<io::File> PakScriptFileDecoder::decode_impl(
     auto data = input_file.stream.read(input_file.stream.size() - offset - 1);
     const s8 seed = input_file.stream.read<u8>();
     algo::crypt::Lcg lcg(algo::crypt::LcgKind::MicrosoftVisualC, seed);
-    for (const auto i : algo::range(0, data.size(), 2))
-        data[i] ^= key[lcg.next() % key.size()];
+    std::vector<u32> key_indices((data.size() + 1) / 2);
+    lcg.fill(key_indices.data(), key_indices.size());
+    for (const auto i : algo::range(key_indices.size()))
+        data[i * 2] ^= key[key_indices[i] % key.size()];
 
     auto output_file = std::make_unique<io::File>(input_file.path, data);
     output_file->path.change_extension("txt");
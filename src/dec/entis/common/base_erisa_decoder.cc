@@ -21,6 +21,29 @@
 using namespace au;
 using namespace au::dec::entis::common;
 
+static inline size_t count_renormalization_bits(u32 augend)
+{
+    size_t bits = 0;
+    if (augend < 0x0100)
+    {
+        augend <<= 8;
+        bits += 8;
+    }
+    if (augend < 0x1000)
+    {
+        augend <<= 4;
+        bits += 4;
+    }
+    if (augend < 0x4000)
+    {
+        augend <<= 2;
+        bits += 2;
+    }
+    if (augend < 0x8000)
+        bits++;
+    return bits;
+}
+
 int BaseErisaDecoder::decode_erisa_code(ProbModel &model)
 {
     const auto index = decode_erisa_code_index(model);
@@ -43,30 +66,24 @@ int BaseErisaDecoder::decode_erisa_code_index(const ProbModel &model)
     if (acc >= prob_total_limit)
         return prob_escape_code;
 
-    size_t symbol_index = 0;
-    u16 fs = 0;
-    u16 occurences;
-    while (true)
-    {
-        occurences = model.sym_table[symbol_index].occurrences;
-        if (acc < occurences)
-            break;
-        acc -= occurences;
-        fs += occurences;
-        if (++symbol_index >= model.symbol_sorts)
-            return prob_escape_code;
-    }
+    u32 fs;
+    const auto symbol_index = model.find_cumulative(acc, fs);
+    if (symbol_index >= model.symbol_sorts)
+        return prob_escape_code;
+    const u32 occurences = model.sym_table[symbol_index].occurrences;
     code_register -= (augend_register * fs + model.total_count - 1)
         / model.total_count;
     augend_register = augend_register * occurences / model.total_count;
     if (augend_register == 0)
         throw err::CorruptDataError("Empty augend register");
 
-    while (!(augend_register & 0x8000))
+    // renormalize in one go rather than bit by bit
+    if (augend_register < 0x8000)
     {
-        code_register <<= 1;
-        code_register |= bit_stream->read(1);
-        augend_register <<= 1;
+        const auto shift = count_renormalization_bits(augend_register);
+        code_register <<= shift;
+        code_register |= bit_stream->read(shift);
+        augend_register <<= shift;
     }
 
     code_register &= 0xFFFF;
@@ -126,6 +126,7 @@ void ErisaNDecoder::reset()
             sym.symbol = 0;
             sym.occurrences = 0;
         }
+        model.rebuild_cumulative_tree();
     }
     p->prob_erisa.work_used = 0;
 }
@@ -295,6 +296,7 @@ void ErisaNDecoder::decode(u8 *output, const size_t output_size)
         new_model.sym_table[j].occurrences = 1;
         new_model.sym_table[j].symbol = prob_escape_code;
         new_model.symbol_sorts = ++j;
+        new_model.rebuild_cumulative_tree();
         for (const auto i : algo::range(new_model.sub_model.size()))
         {
             new_model.sub_model[i].occurrences = 0;
@@ -21,6 +21,11 @@
 using namespace au;
 using namespace au::dec::entis::common;
 
+static inline size_t lowest_bit(const size_t n)
+{
+    return n & (~n + 1);
+}
+
 ProbModel::ProbModel()
 {
     total_count = sym_table.size();
@@ -37,20 +42,29 @@ ProbModel::ProbModel()
         sub_model[i].occurrences = 0;
         sub_model[i].symbol = -1;
     }
+    rebuild_cumulative_tree();
 }
 
 void ProbModel::increase_symbol(size_t index)
 {
     sym_table[index].occurrences++;
     const auto symbol_to_bump = sym_table[index];
+    // occurrence count of the current slot as seen by the cumulative tree
+    s32 tree_occurrences = symbol_to_bump.occurrences - 1;
     while (index > 0)
     {
         if (sym_table[index - 1].occurrences >= symbol_to_bump.occurrences)
             break;
         sym_table[index] = sym_table[index - 1];
+        // zero for sorted tables, where all shifted symbols tie
+        const s32 delta = sym_table[index].occurrences - tree_occurrences;
+        if (delta)
+            add_cumulative(index, delta);
         index--;
+        tree_occurrences = sym_table[index].occurrences;
     }
     sym_table[index] = symbol_to_bump;
+    add_cumulative(index, symbol_to_bump.occurrences - tree_occurrences);
     total_count++;
     if (total_count >= prob_total_limit)
         half_occurrence_count();
@@ -66,6 +80,7 @@ void ProbModel::half_occurrence_count()
     }
     for (const auto i : algo::range(sub_model.size()))
         sub_model[i].occurrences >>= 1;
+    rebuild_cumulative_tree();
 }
 
 void ProbModel::add_symbol(const s16 symbol)
@@ -73,6 +88,7 @@ void ProbModel::add_symbol(const s16 symbol)
     const auto index = symbol_sorts++;
     sym_table[index].symbol = symbol;
     sym_table[index].occurrences = 1;
+    add_cumulative(index, 1);
     total_count++;
 }
 
@@ -86,3 +102,35 @@ s16 ProbModel::find_symbol(const s16 symbol) const
     }
     return sym;
 }
+
+void ProbModel::rebuild_cumulative_tree()
+{
+    cumulative_tree.fill(0);
+    for (const auto i : algo::range(symbol_sorts))
+        add_cumulative(i, sym_table[i].occurrences);
+}
+
+size_t ProbModel::find_cumulative(
+    const u32 count, u32 &preceding_count) const
+{
+    size_t index = 0;
+    u32 remaining = count;
+    // highest power of two that fits in prob_symbol_sorts
+    for (size_t step = 0x100; step; step >>= 1)
+    {
+        if (index + step <= symbol_sorts
+            && cumulative_tree[index + step] <= remaining)
+        {
+            index += step;
+            remaining -= cumulative_tree[index];
+        }
+    }
+    preceding_count = count - remaining;
+    return index;
+}
+
+void ProbModel::add_cumulative(size_t index, const s32 delta)
+{
+    for (index++; index < cumulative_tree.size(); index += lowest_bit(index))
+        cumulative_tree[index] += delta;
+}
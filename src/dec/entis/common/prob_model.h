@@ -44,10 +44,24 @@ namespace common {
         void add_symbol(const s16 symbol);
         s16 find_symbol(const s16 symbol) const;
 
+        // Must be called after modifying sym_table or symbol_sorts directly.
+        void rebuild_cumulative_tree();
+
+        // Returns the index of the symbol whose cumulative range contains
+        // given count, or symbol_sorts if there's no such symbol. Also
+        // yields the sum of occurrences of all preceding symbols.
+        size_t find_cumulative(const u32 count, u32 &preceding_count) const;
+
         u32 total_count;
         u32 symbol_sorts;
         std::array<CodeSymbol, prob_symbol_sorts> sym_table;
         std::array<CodeSymbol, prob_sub_sort_max> sub_model;
+
+    private:
+        void add_cumulative(size_t index, const s32 delta);
+
+        // Fenwick tree over sym_table occurrences, 1-based
+        std::array<u32, prob_symbol_sorts + 1> cumulative_tree;
     };
 
 } } } }
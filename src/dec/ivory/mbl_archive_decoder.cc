@@ -16,6 +16,7 @@
 // along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
 
 #include "dec/ivory/mbl_archive_decoder.h"
+#include "algo/crypt/xor.h"
 #include "algo/format.h"
 #include "algo/locale.h"
 #include "algo/range.h"
@@ -89,8 +90,7 @@ MblArchiveDecoder::MblArchiveDecoder()
         {
             static const bstr key =
                 "\x82\xED\x82\xF1\x82\xB1\x88\xC3\x8D\x86\x89\xBB"_b;
-            for (const auto i : algo::range(data.size()))
-                data[i] ^= key[i % key.size()];
+            algo::crypt::xor_repeating(data, key);
         });
 
     add_arg_parser_decorator(
@@ -25,11 +25,53 @@ using namespace au::dec::jpeg;
 
 static const bstr magic = "\xFF\xD8\xFF"_b;
 
+JpegImageDecoder::JpegImageDecoder() : pass_through(false)
+{
+    add_arg_parser_decorator(
+        [](ArgParser &arg_parser)
+        {
+            arg_parser.register_flag({"--jpeg-passthrough"})
+                ->set_description(
+                    "Saves JPEG files found inside other files as they are, "
+                    "instead of converting them to PNG.");
+        },
+        [&](const ArgParser &arg_parser)
+        {
+            if (arg_parser.has_flag("--jpeg-passthrough"))
+                pass_through = true;
+        });
+}
+
+std::string JpegImageDecoder::canonical_extension() const
+{
+    return "jpg";
+}
+
+bool JpegImageDecoder::is_canonical_format() const
+{
+    return pass_through;
+}
+
 bool JpegImageDecoder::is_recognized_impl(io::File &input_file) const
 {
     return input_file.stream.read(magic.size()) == magic;
 }
 
+static void read_scanlines(
+    jpeg_decompress_struct &info, u8 *output, const size_t stride)
+{
+    std::vector<JSAMPROW> rows(info.output_height);
+    for (const auto y : algo::range(info.output_height))
+        rows[y] = output + y * stride;
+    while (info.output_scanline < info.output_height)
+    {
+        jpeg_read_scanlines(
+            &info,
+            rows.data() + info.output_scanline,
+            info.output_height - info.output_scanline);
+    }
+}
+
 res::Image JpegImageDecoder::decode_impl(
     const Logger &logger, io::File &input_file) const
 {
@@ -41,6 +83,24 @@ res::Image JpegImageDecoder::decode_impl(
     jpeg_create_decompress(&info);
     jpeg_mem_src(&info, source.get<u8>(), source.size());
     jpeg_read_header(&info, TRUE);
+
+    #ifdef JCS_ALPHA_EXTENSIONS
+        // let libjpeg-turbo write pixels straight into the image
+        if (info.num_components == 3)
+        {
+            info.out_color_space = JCS_EXT_BGRA;
+            jpeg_start_decompress(&info);
+            res::Image image(info.output_width, info.output_height);
+            read_scanlines(
+                info,
+                reinterpret_cast<u8*>(image.begin()),
+                image.width() * sizeof(res::Pixel));
+            jpeg_finish_decompress(&info);
+            jpeg_destroy_decompress(&info);
+            return image;
+        }
+    #endif
+
     jpeg_start_decompress(&info);
 
     const auto width = info.output_width;
@@ -62,11 +122,7 @@ res::Image JpegImageDecoder::decode_impl(
     }
 
     bstr raw_data(width * height * channels);
-    for (const auto y : algo::range(height))
-    {
-        auto ptr = raw_data.get<u8>() + y * width * channels;
-        jpeg_read_scanlines(&info, &ptr, 1);
-    }
+    read_scanlines(info, raw_data.get<u8>(), width * channels);
     jpeg_finish_decompress(&info);
     jpeg_destroy_decompress(&info);
 
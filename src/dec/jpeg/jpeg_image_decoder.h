@@ -25,10 +25,18 @@ namespace jpeg {
 
     class JpegImageDecoder final : public BaseImageDecoder
     {
+    public:
+        JpegImageDecoder();
+        std::string canonical_extension() const override;
+
     protected:
+        bool is_canonical_format() const override;
         bool is_recognized_impl(io::File &input_file) const override;
         res::Image decode_impl(
             const Logger &logger, io::File &input_file) const override;
+
+    private:
+        bool pass_through;
     };
 
 } } }
@@ -18,8 +18,10 @@
 #include "dec/kaguya/base_link_archive_decoder.h"
 #include "algo/locale.h"
 #include "algo/range.h"
+#include "asset_cache.h"
 #include "dec/kaguya/common/params_encryption.h"
 #include "err.h"
+#include "io/file_system.h"
 #include "virtual_file_system.h"
 
 using namespace au;
@@ -29,7 +31,7 @@ namespace
 {
     struct CustomArchiveMeta final : dec::ArchiveMeta
     {
-        common::Params params;
+        std::shared_ptr<const common::Params> params;
     };
 
     struct CustomArchiveEntry final : dec::PlainArchiveEntry
@@ -38,22 +40,39 @@ namespace
     };
 }
 
-std::unique_ptr<dec::ArchiveMeta> BaseLinkArchiveDecoder::read_meta_impl(
-    const Logger &logger, io::File &input_file) const
+// All archives of a game share params.dat, so it's parsed only once.
+// Copies that aren't on disk, such as ones found in other archives, can't
+// be told apart cheaply and are parsed every time.
+static std::shared_ptr<const common::Params> read_params(const Logger &logger)
 {
-    auto meta = std::make_unique<CustomArchiveMeta>();
     auto params_file = VirtualFileSystem::get_by_name("params.dat");
-    if (params_file)
+    if (!params_file)
+        return nullptr;
+    const auto parse = [&]()
     {
-        try
-        {
-            meta->params = common::parse_params_file(params_file->stream);
-        }
-        catch (const std::exception &e)
-        {
-            logger.warn("%s\n", e.what());
-        }
+        return std::make_shared<const common::Params>(
+            common::parse_params_file(params_file->stream));
+    };
+    try
+    {
+        if (!io::is_regular_file(params_file->path))
+            return parse();
+        return AssetCache::get<common::Params>(
+            "kaguya/params:" + AssetCache::identify_file(params_file->path),
+            parse);
     }
+    catch (const std::exception &e)
+    {
+        logger.warn("%s\n", e.what());
+        return nullptr;
+    }
+}
+
+std::unique_ptr<dec::ArchiveMeta> BaseLinkArchiveDecoder::read_meta_impl(
+    const Logger &logger, io::File &input_file) const
+{
+    auto meta = std::make_unique<CustomArchiveMeta>();
+    meta->params = read_params(logger);
 
     if (get_version() == 3)
     {
@@ -118,17 +137,14 @@ std::unique_ptr<io::File> BaseLinkArchiveDecoder::read_file_impl(
 {
     const auto meta = static_cast<const CustomArchiveMeta*>(&m);
     const auto entry = static_cast<const CustomArchiveEntry*>(&e);
-    auto output_file = std::make_unique<io::File>(entry->path, ""_b);
-    output_file->stream.write(
-        input_file.stream.seek(entry->offset), entry->size);
-
+    auto data = input_file.stream.seek(entry->offset).read(entry->size);
     if (entry->encrypted)
     {
-        if (meta->params.key.empty())
+        if (!meta->params || meta->params->key.empty())
             throw err::CorruptDataError("Missing decryption params");
-        common::decrypt(output_file->stream, meta->params);
+        common::decrypt(data, *meta->params);
     }
-    return output_file;
+    return std::make_unique<io::File>(entry->path, std::move(data));
 }
 
 std::vector<std::string> BaseLinkArchiveDecoder::get_linked_formats() const
@@ -16,10 +16,11 @@
 // along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
 
 #include "dec/kaguya/common/params_encryption.h"
-#include "algo/binary.h"
+#include "algo/crypt/xor.h"
 #include "algo/locale.h"
 #include "algo/range.h"
 #include "err.h"
+#include "io/span_reader.h"
 
 using namespace au;
 using namespace au::dec::kaguya;
@@ -59,18 +60,41 @@ static bool verify_magic(io::BaseByteStream &input_stream, const bstr &magic)
     return verify_magic(input_stream, {magic});
 }
 
+static bool has_magic(
+    const bstr &data, const std::initializer_list<bstr> &magic_list)
+{
+    for (const auto &magic : magic_list)
+        if (data.substr(0, magic.size()) == magic)
+            return true;
+    return false;
+}
+
+static bool has_magic(const bstr &data, const bstr &magic)
+{
+    return has_magic(data, {magic});
+}
+
+// Decrypts the next given number of bytes in place, without round-tripping
+// them through the stream.
 static void decrypt(
-    io::BaseByteStream &input_stream, const bstr &key, const size_t size)
+    bstr &data,
+    io::SpanReader &input_stream,
+    const bstr &key,
+    const size_t size)
 {
-    const auto old_pos = input_stream.pos();
-    const auto data = algo::unxor(input_stream.read(size), key);
-    input_stream.seek(old_pos);
-    input_stream.write(data);
+    if (size > input_stream.left())
+        throw err::EofError();
+    algo::crypt::xor_repeating(
+        data.get<u8>() + input_stream.pos(),
+        size,
+        key.get<const u8>(),
+        key.size());
+    input_stream.skip(size);
 }
 
-static void decrypt(io::BaseByteStream &input_stream, const bstr &key)
+static void decrypt(bstr &data, io::SpanReader &input_stream, const bstr &key)
 {
-    decrypt(input_stream, key, input_stream.left());
+    decrypt(data, input_stream, key, input_stream.left());
 }
 
 static int get_scr_version(io::BaseByteStream &input_stream)
@@ -310,19 +334,19 @@ common::Params common::parse_params_file(io::BaseByteStream &input_stream)
     return parse_params_file_v3_or_later(input_stream, version);
 }
 
-void common::decrypt(
-    io::BaseByteStream &input_stream, const common::Params &params)
+void common::decrypt(bstr &data, const common::Params &params)
 {
-    if (verify_magic(input_stream, "BM"_b))
-        ::decrypt(input_stream.seek(54), params.key);
+    io::SpanReader input_stream(data);
+    if (has_magic(data, "BM"_b))
+        ::decrypt(data, input_stream.seek(54), params.key);
 
-    else if (verify_magic(input_stream, {"AP-3"_b, "AP-2"_b}))
-         ::decrypt(input_stream.seek(24), params.key);
+    else if (has_magic(data, {"AP-3"_b, "AP-2"_b}))
+         ::decrypt(data, input_stream.seek(24), params.key);
 
-    else if (verify_magic(input_stream, {"AP-1"_b, "AP-0"_b, "AP"_b}))
-         ::decrypt(input_stream.seek(12), params.key);
+    else if (has_magic(data, {"AP-1"_b, "AP-0"_b, "AP"_b}))
+         ::decrypt(data, input_stream.seek(12), params.key);
 
-    else if (verify_magic(input_stream, "AN00"_b) && params.decrypt_anm)
+    else if (has_magic(data, "AN00"_b) && params.decrypt_anm)
     {
         input_stream.seek(20);
         const auto frame_count = input_stream.read_le<u16>();
@@ -333,11 +357,11 @@ void common::decrypt(
             input_stream.skip(8);
             const auto width = input_stream.read_le<u32>();
             const auto height = input_stream.read_le<u32>();
-            ::decrypt(input_stream, params.key, 4 * width * height);
+            ::decrypt(data, input_stream, params.key, 4 * width * height);
         }
     }
 
-    else if (verify_magic(input_stream, "AN10"_b) && params.decrypt_anm)
+    else if (has_magic(data, "AN10"_b) && params.decrypt_anm)
     {
         input_stream.seek(20);
         const auto frame_count = input_stream.read_le<u16>();
@@ -349,11 +373,12 @@ void common::decrypt(
             const auto width = input_stream.read_le<u32>();
             const auto height = input_stream.read_le<u32>();
             const auto channels = input_stream.read_le<u32>();
-            ::decrypt(input_stream, params.key, channels * width * height);
+            ::decrypt(
+                data, input_stream, params.key, channels * width * height);
         }
     }
 
-    else if (verify_magic(input_stream, "AN20"_b) && params.decrypt_anm)
+    else if (has_magic(data, "AN20"_b) && params.decrypt_anm)
     {
         input_stream.seek(4);
         const auto unk_count = input_stream.read_le<u16>();
@@ -381,11 +406,12 @@ void common::decrypt(
             const auto width = input_stream.read_le<u32>();
             const auto height = input_stream.read_le<u32>();
             const auto channels = input_stream.read_le<u32>();
-            ::decrypt(input_stream, params.key, channels * width * height);
+            ::decrypt(
+                data, input_stream, params.key, channels * width * height);
         }
     }
 
-    else if (verify_magic(input_stream, "AN21"_b) && params.decrypt_anm)
+    else if (has_magic(data, "AN21"_b) && params.decrypt_anm)
     {
         input_stream.seek(4);
         const auto unk_count = input_stream.read_le<u16>();
@@ -411,10 +437,10 @@ void common::decrypt(
         const auto width = input_stream.read_le<u32>();
         const auto height = input_stream.read_le<u32>();
         const auto channels = input_stream.read_le<u32>();
-        ::decrypt(input_stream, params.key, channels * width * height);
+        ::decrypt(data, input_stream, params.key, channels * width * height);
     }
 
-    else if (verify_magic(input_stream, "PL00"_b))
+    else if (has_magic(data, "PL00"_b))
     {
         input_stream.seek(4);
         const auto file_count = input_stream.read_le<u16>();
@@ -425,11 +451,12 @@ void common::decrypt(
             const auto width = input_stream.read_le<u32>();
             const auto height = input_stream.read_le<u32>();
             const auto channels = input_stream.read_le<u32>();
-            ::decrypt(input_stream, params.key, channels * width * height);
+            ::decrypt(
+                data, input_stream, params.key, channels * width * height);
         }
     }
 
-    else if (verify_magic(input_stream, "PL10"_b))
+    else if (has_magic(data, "PL10"_b))
     {
         input_stream.seek(4);
         const auto file_count = input_stream.read_le<u16>();
@@ -438,6 +465,6 @@ void common::decrypt(
         const auto width = input_stream.read_le<u32>();
         const auto height = input_stream.read_le<u32>();
         const auto channels = input_stream.read_le<u32>();
-        ::decrypt(input_stream, params.key, channels * width * height);
+        ::decrypt(data, input_stream, params.key, channels * width * height);
     }
 }
@@ -33,7 +33,7 @@ namespace common {
 
     Params parse_params_file(io::BaseByteStream &input_stream);
 
-    void decrypt(
-        io::BaseByteStream &input_stream, const common::Params &params);
+    // Decrypts the payload of a file extracted from a LINK archive in place.
+    void decrypt(bstr &data, const common::Params &params);
 
 } } } }
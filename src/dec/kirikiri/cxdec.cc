@@ -17,6 +17,7 @@
 
 #include "dec/kirikiri/cxdec.h"
 #include "algo/range.h"
+#include "asset_cache.h"
 #include "err.h"
 #include "io/file_byte_stream.h"
 #include "io/file_system.h"
@@ -44,24 +45,67 @@ namespace
         std::array<size_t, 6> key_derivation_order3;
     };
 
+    enum class Opcode : u8
+    {
+        PushConstant,
+        PushParameter,
+
+        // act on the top of the stack
+        Not,
+        Decrement,
+        Negate,
+        Increment,
+        LookUpControlBlock,
+        SwapBits,
+        XorConstant,
+        AddConstant,
+        SubtractConstant,
+
+        // pop the top, combine it with the value below (ebx)
+        ShiftRight,
+        ShiftLeft,
+        Add,
+        NegateAndAdd,
+        Multiply,
+        Subtract,
+    };
+
+    struct Instruction final
+    {
+        Opcode opcode;
+        u32 operand;
+    };
+
+    // The generated code depends only on the seed, and the parameter merely
+    // flows through it, so rather than emulating the code generator for
+    // every derivation, programs for all seeds are recorded once as flat
+    // instruction lists that are then evaluated for given parameter.
     class KeyDeriver final
     {
     public:
         KeyDeriver(const CxdecSettings &settings);
-        u32 derive(u32 seed, u32 parameter);
+        u32 derive(u32 seed, u32 parameter) const;
 
     private:
+        using Program = std::vector<Instruction>;
+
+        Program compile(u32 seed);
+        void emit(const Opcode opcode, const u32 operand = 0);
         void add_shellcode(const bstr &bytes_s);
         u32 rand();
-        u32 derive_for_stage(size_t stage);
-        u32 run_first_stage();
-        u32 run_stage_strategy_0(size_t stage);
-        u32 run_stage_strategy_1(size_t stage);
+        void derive_for_stage(size_t stage);
+        void run_first_stage();
+        void run_stage_strategy_0(size_t stage);
+        void run_stage_strategy_1(size_t stage);
+        u32 read_control_block(const size_t pos) const;
 
-        const CxdecSettings &settings;
+        const CxdecSettings settings;
+        std::array<Program, 0x80> programs;
+
+        // code generator state
         bstr shellcode;
+        Program program;
         u32 seed;
-        size_t parameter;
         u32 control_block_addr;
     };
 }
@@ -73,15 +117,121 @@ static bstr u32_to_string(u32 value)
 
 KeyDeriver::KeyDeriver(const CxdecSettings &settings) : settings(settings)
 {
-    seed = 0;
-    parameter = 0;
-    control_block_addr = reinterpret_cast<size_t>(&settings.control_block);
+    control_block_addr
+        = reinterpret_cast<size_t>(&this->settings.control_block);
+    for (const auto seed : algo::range(programs.size()))
+    {
+        try
+        {
+            programs[seed] = compile(seed);
+        }
+        catch (const err::NotSupportedError &)
+        {
+            // resurfaces when a file actually uses this seed
+        }
+    }
 }
 
-u32 KeyDeriver::derive(u32 seed, u32 parameter)
+u32 KeyDeriver::derive(u32 seed, u32 parameter) const
+{
+    if (seed >= programs.size() || programs[seed].empty())
+    {
+        throw err::NotSupportedError(
+            "Failed to derive the key from the parameter");
+    }
+
+    // nesting is at most 5 stages deep, each holding one value
+    u32 stack[8];
+    size_t size = 0;
+    for (const auto &instruction : programs[seed])
+    {
+        const auto operand = instruction.operand;
+        if (instruction.opcode == Opcode::PushConstant)
+        {
+            stack[size++] = operand;
+            continue;
+        }
+        if (instruction.opcode == Opcode::PushParameter)
+        {
+            stack[size++] = parameter;
+            continue;
+        }
+
+        auto &eax = stack[size - 1];
+        switch (instruction.opcode)
+        {
+            case Opcode::Not:
+                eax ^= 0xFFFFFFFF;
+                break;
+
+            case Opcode::Decrement:
+                eax--;
+                break;
+
+            case Opcode::Negate:
+                eax = static_cast<u32>(-static_cast<s32>(eax));
+                break;
+
+            case Opcode::Increment:
+                eax++;
+                break;
+
+            case Opcode::LookUpControlBlock:
+                eax = read_control_block((eax & 0x3FF) * 4);
+                break;
+
+            case Opcode::SwapBits:
+                eax = ((eax & 0xAAAAAAAA) >> 1) | ((eax & 0x55555555) << 1);
+                break;
+
+            case Opcode::XorConstant:
+                eax ^= operand;
+                break;
+
+            case Opcode::AddConstant:
+                eax += operand;
+                break;
+
+            case Opcode::SubtractConstant:
+                eax -= operand;
+                break;
+
+            default:
+            {
+                const auto value = stack[--size];
+                auto &ebx = stack[size - 1];
+                switch (instruction.opcode)
+                {
+                    case Opcode::ShiftRight:
+                        ebx = value >> (ebx & 0x0F);
+                        break;
+                    case Opcode::ShiftLeft:
+                        ebx = value << (ebx & 0x0F);
+                        break;
+                    case Opcode::Add:
+                        ebx = value + ebx;
+                        break;
+                    case Opcode::NegateAndAdd:
+                        ebx = ebx - value;
+                        break;
+                    case Opcode::Multiply:
+                        ebx = value * ebx;
+                        break;
+                    case Opcode::Subtract:
+                        ebx = value - ebx;
+                        break;
+                    default:
+                        throw std::logic_error("Bad opcode");
+                }
+            }
+        }
+    }
+    return stack[0];
+}
+
+KeyDeriver::Program KeyDeriver::compile(u32 seed)
 {
     this->seed = seed;
-    this->parameter = parameter;
 
     // What we do: we try to run a code a few times for different "stages".
     // The first one to succeed yields the key.
@@ -99,7 +249,8 @@ u32 KeyDeriver::derive(u32 seed, u32 parameter)
     {
         try
         {
-            return derive_for_stage(stage);
+            derive_for_stage(stage);
+            return program;
         }
         catch (const KeyDerivationError)
         {
@@ -110,6 +261,11 @@ u32 KeyDeriver::derive(u32 seed, u32 parameter)
     throw err::NotSupportedError("Failed to derive the key from the parameter");
 }
 
+void KeyDeriver::emit(const Opcode opcode, const u32 operand)
+{
+    program.push_back({opcode, operand});
+}
+
 void KeyDeriver::add_shellcode(const bstr &bytes)
 {
     // The execution for current stage must fail when we run code for too long.
@@ -128,9 +284,15 @@ u32 KeyDeriver::rand()
     return seed ^ (old_seed << 16) ^ (old_seed >> 16);
 }
 
-u32 KeyDeriver::derive_for_stage(size_t stage)
+u32 KeyDeriver::read_control_block(const size_t pos) const
+{
+    return *reinterpret_cast<const u32*>(&settings.control_block[pos]);
+}
+
+void KeyDeriver::derive_for_stage(size_t stage)
 {
     shellcode = ""_b;
+    program.clear();
 
     // push edi, push esi, push ebx, push ecx, push edx
     add_shellcode("\x57\x56\x53\x51\x52"_b);
@@ -138,22 +300,19 @@ u32 KeyDeriver::derive_for_stage(size_t stage)
     // mov edi, dword ptr ss:[esp+18] (esp+18 == parameter)
     add_shellcode("\x86\x7C\x24\x18"_b);
 
-    const auto eax = run_stage_strategy_1(stage);
+    run_stage_strategy_1(stage);
 
     // pop edx, pop ecx, pop ebx, pop esi, pop edi
     add_shellcode("\x5A\x59\x5B\x5E\x5F"_b);
 
     // retn
     add_shellcode("\xC3"_b);
-
-    return eax;
 }
 
-u32 KeyDeriver::run_first_stage()
+void KeyDeriver::run_first_stage()
 {
     const auto routine_number = settings.key_derivation_order1[rand() % 3];
 
-    u32 eax;
     switch (routine_number)
     {
         case 0:
@@ -162,14 +321,14 @@ u32 KeyDeriver::run_first_stage()
             add_shellcode("\xB8"_b);
             const auto tmp = rand();
             add_shellcode(u32_to_string(tmp));
-            eax = tmp;
+            emit(Opcode::PushConstant, tmp);
             break;
         }
 
         case 1:
             // mov eax, edi
             add_shellcode("\xB8\xC7"_b);
-            eax = parameter;
+            emit(Opcode::PushParameter);
             break;
 
         case 2:
@@ -183,25 +342,24 @@ u32 KeyDeriver::run_first_stage()
             const auto pos = (rand() & 0x3FF) * 4;
             add_shellcode(u32_to_string(pos));
 
-            eax = *reinterpret_cast<const u32*>(&settings.control_block[pos]);
+            emit(Opcode::PushConstant, read_control_block(pos));
             break;
         }
 
         default:
             throw std::logic_error("Bad routine number");
     }
-
-    return eax;
 }
 
-u32 KeyDeriver::run_stage_strategy_0(size_t stage)
+void KeyDeriver::run_stage_strategy_0(size_t stage)
 {
     if (stage == 1)
         return run_first_stage();
 
-    auto eax = (rand() & 1)
-        ? run_stage_strategy_1(stage - 1)
-        : run_stage_strategy_0(stage - 1);
+    if (rand() & 1)
+        run_stage_strategy_1(stage - 1);
+    else
+        run_stage_strategy_0(stage - 1);
 
     const auto routine_number = settings.key_derivation_order2[rand() % 8];
 
@@ -210,25 +368,25 @@ u32 KeyDeriver::run_stage_strategy_0(size_t stage)
         case 0:
             // not eax
             add_shellcode("\xF7\xD0"_b);
-            eax ^= 0xFFFFFFFF;
+            emit(Opcode::Not);
             break;
 
         case 1:
             // dec eax
             add_shellcode("\x48"_b);
-            eax--;
+            emit(Opcode::Decrement);
             break;
 
         case 2:
             // neg eax
             add_shellcode("\xF7\xD8"_b);
-            eax = static_cast<u32>(-static_cast<s32>(eax));
+            emit(Opcode::Negate);
             break;
 
         case 3:
             // inc eax
             add_shellcode("\x40"_b);
-            eax++;
+            emit(Opcode::Increment);
             break;
 
         case 4:
@@ -242,8 +400,7 @@ u32 KeyDeriver::run_stage_strategy_0(size_t stage)
             // mov eax, dword ptr ds:[esi+eax*4]
             add_shellcode("\x8B\x04\x86"_b);
 
-            eax = *reinterpret_cast<const u32*>(
-                &settings.control_block[(eax & 0x3FF) * 4]);
+            emit(Opcode::LookUpControlBlock);
             break;
 
         case 5:
@@ -272,12 +429,7 @@ u32 KeyDeriver::run_stage_strategy_0(size_t stage)
             // pop ebx
             add_shellcode("\x5B"_b);
 
-            auto ebx = eax;
-            ebx &= 0xAAAAAAAA;
-            eax &= 0x55555555;
-            ebx >>= 1;
-            eax <<= 1;
-            eax |= ebx;
+            emit(Opcode::SwapBits);
             break;
         }
 
@@ -288,7 +440,7 @@ u32 KeyDeriver::run_stage_strategy_0(size_t stage)
             const auto tmp = rand();
             add_shellcode(u32_to_string(tmp));
 
-            eax ^= tmp;
+            emit(Opcode::XorConstant, tmp);
             break;
         }
 
@@ -301,7 +453,7 @@ u32 KeyDeriver::run_stage_strategy_0(size_t stage)
                 const auto tmp = rand();
                 add_shellcode(u32_to_string(tmp));
 
-                eax += tmp;
+                emit(Opcode::AddConstant, tmp);
             }
             else
             {
@@ -310,7 +462,7 @@ u32 KeyDeriver::run_stage_strategy_0(size_t stage)
                 const auto tmp = rand();
                 add_shellcode(u32_to_string(tmp));
 
-                eax -= tmp;
+                emit(Opcode::SubtractConstant, tmp);
             }
             break;
         }
@@ -318,11 +470,9 @@ u32 KeyDeriver::run_stage_strategy_0(size_t stage)
         default:
             throw std::logic_error("Bad routine number");
     }
-
-    return eax;
 }
 
-u32 KeyDeriver::run_stage_strategy_1(size_t stage)
+void KeyDeriver::run_stage_strategy_1(size_t stage)
 {
     if (stage == 1)
         return run_first_stage();
@@ -330,17 +480,18 @@ u32 KeyDeriver::run_stage_strategy_1(size_t stage)
     // push ebx
     add_shellcode("\x53"_b);
 
-    auto eax = (rand() & 1)
-        ? run_stage_strategy_1(stage - 1)
-        : run_stage_strategy_0(stage - 1);
+    if (rand() & 1)
+        run_stage_strategy_1(stage - 1);
+    else
+        run_stage_strategy_0(stage - 1);
 
     // mov ebx, eax
     add_shellcode("\x89\xC3"_b);
-    const auto ebx = eax;
 
-    eax = (rand() & 1)
-        ? run_stage_strategy_1(stage - 1)
-        : run_stage_strategy_0(stage - 1);
+    if (rand() & 1)
+        run_stage_strategy_1(stage - 1);
+    else
+        run_stage_strategy_0(stage - 1);
 
     const auto routine_number = settings.key_derivation_order3[rand() % 6];
     switch (routine_number)
@@ -362,8 +513,7 @@ u32 KeyDeriver::run_stage_strategy_1(size_t stage)
             // pop ecx
             add_shellcode("\x59"_b);
 
-            const auto ecx = ebx & 0x0F;
-            eax >>= ecx;
+            emit(Opcode::ShiftRight);
             break;
         }
 
@@ -384,15 +534,14 @@ u32 KeyDeriver::run_stage_strategy_1(size_t stage)
             // pop ecx
             add_shellcode("\x59"_b);
 
-            const auto ecx = ebx & 0x0F;
-            eax <<= ecx;
+            emit(Opcode::ShiftLeft);
             break;
         }
 
         case 2:
             // add eax, ebx
             add_shellcode("\x01\xD8"_b);
-            eax += ebx;
+            emit(Opcode::Add);
             break;
 
         case 3:
@@ -400,19 +549,19 @@ u32 KeyDeriver::run_stage_strategy_1(size_t stage)
             add_shellcode("\xF7\xD8"_b);
             // add eax, ebx
             add_shellcode("\x01\xD8"_b);
-            eax = ebx - eax;
+            emit(Opcode::NegateAndAdd);
             break;
 
         case 4:
             // imul eax, ebx
             add_shellcode("\x0F\xAF\xC3"_b);
-            eax *= ebx;
+            emit(Opcode::Multiply);
             break;
 
         case 5:
             // sub eax, ebx
             add_shellcode("\x29\xD8"_b);
-            eax -= ebx;
+            emit(Opcode::Subtract);
             break;
 
         default:
@@ -421,12 +570,10 @@ u32 KeyDeriver::run_stage_strategy_1(size_t stage)
 
     // pop ebx
     add_shellcode("\x5B"_b);
-
-    return eax;
 }
 
 static void decrypt_chunk(
-    KeyDeriver &key_deriver,
+    const KeyDeriver &key_deriver,
     bstr &data,
     u32 hash,
     size_t base_offset,
@@ -456,9 +603,8 @@ static void decrypt_chunk(
         data_ptr[i] ^= xor2;
 }
 
-static bstr find_control_block(const io::path &path)
+static bstr find_control_block_uncached(const io::path &dir)
 {
-    const auto dir = path.parent();
     for (const auto &path : io::recursive_directory_range(dir))
     {
         if (!io::is_regular_file(path))
@@ -486,6 +632,20 @@ static bstr find_control_block(const io::path &path)
     throw err::FileNotFoundError("TPM file not found");
 }
 
+// All archives of a game share the control block, and looking for it means
+// walking the whole game directory.
+static bstr find_control_block(const io::path &path)
+{
+    const auto dir = path.parent();
+    return *AssetCache::get_transient<bstr>(
+        "kirikiri/cxdec/control-block:" + io::absolute(dir).str(),
+        [&]()
+        {
+            return std::make_shared<const bstr>(
+                find_control_block_uncached(dir));
+        });
+}
+
 Xp3Plugin au::dec::kirikiri::create_cxdec_plugin(
     const u16 key1,
     const u16 key2,
@@ -505,19 +665,37 @@ Xp3Plugin au::dec::kirikiri::create_cxdec_plugin(
         settings.key_derivation_order1 = key_derivation_order1;
         settings.key_derivation_order2 = key_derivation_order2;
         settings.key_derivation_order3 = key_derivation_order3;
+        const auto key_deriver = std::make_shared<const KeyDeriver>(settings);
 
         return [=](bstr &data, u32 adlr_key)
         {
-            KeyDeriver key_deriver(settings);
             const auto hash1 = adlr_key;
             const auto hash2 = (adlr_key >> 16) ^ adlr_key;
             const auto offset1 = 0;
             const auto offset2 = std::min<size_t>(
                 data.size(), (adlr_key & key1) + key2);
-            decrypt_chunk(key_deriver, data, hash1, offset1, offset2);
+            decrypt_chunk(*key_deriver, data, hash1, offset1, offset2);
             decrypt_chunk(
-                key_deriver, data, hash2, offset2, data.size() - offset2);
+                *key_deriver, data, hash2, offset2, data.size() - offset2);
         };
     };
     return plugin;
 }
+
+u32 au::dec::kirikiri::derive_cxdec_key(
+    const bstr &control_block,
+    const std::array<size_t, 3> key_derivation_order1,
+    const std::array<size_t, 8> key_derivation_order2,
+    const std::array<size_t, 6> key_derivation_order3,
+    const u32 seed,
+    const u32 parameter)
+{
+    if (control_block.size() != control_block_size)
+        throw err::BadDataSizeError();
+    CxdecSettings settings;
+    settings.control_block = control_block;
+    settings.key_derivation_order1 = key_derivation_order1;
+    settings.key_derivation_order2 = key_derivation_order2;
+    settings.key_derivation_order3 = key_derivation_order3;
+    return KeyDeriver(settings).derive(seed & 0x7F, parameter);
+}
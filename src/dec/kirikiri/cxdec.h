@@ -32,4 +32,14 @@ namespace kirikiri {
         const std::array<size_t, 6> key_derivation_order3,
         const bstr &control_block = ""_b);
 
+    // Returns the key that the routine generated for given seed (0..0x7F)
+    // computes from given parameter, as done twice for every file chunk.
+    u32 derive_cxdec_key(
+        const bstr &control_block,
+        const std::array<size_t, 3> key_derivation_order1,
+        const std::array<size_t, 8> key_derivation_order2,
+        const std::array<size_t, 6> key_derivation_order3,
+        const u32 seed,
+        const u32 parameter);
+
 } } }
@@ -19,6 +19,7 @@
 #include "algo/range.h"
 #include "dec/kirikiri/tlg/lzss_decompressor.h"
 #include "err.h"
+#include "res/image_kernels.h"
 
 using namespace au;
 using namespace au::dec::kirikiri::tlg;
@@ -57,45 +58,6 @@ void BlockInfo::decompress(LzssDecompressor &decompressor, const Header &header)
     data = decompressor.decompress(data, output_size);
 }
 
-static void load_pixel_block_row(
-    res::Image &image,
-    std::vector<std::unique_ptr<BlockInfo>> channel_data,
-    const Header &header,
-    int block_y)
-{
-    size_t max_y = std::min(block_y + header.block_height, header.image_height);
-    bool use_alpha = header.channel_count == 4;
-
-    for (const auto y : algo::range(block_y, max_y))
-    {
-        size_t block_y_shift = (y - block_y) * header.image_width;
-        u8 prev_pixel[4] = {0, 0, 0, 0};
-
-        for (const auto x : algo::range(header.image_width))
-        {
-            res::Pixel pixel;
-            pixel.b = channel_data[0]->data.get<u8>()[block_y_shift + x];
-            pixel.g = channel_data[1]->data.get<u8>()[block_y_shift + x];
-            pixel.r = channel_data[2]->data.get<u8>()[block_y_shift + x];
-            if (use_alpha)
-                pixel.a = channel_data[3]->data.get<u8>()[block_y_shift + x];
-            else
-                pixel.a = 0xFF;
-            pixel.b += pixel.g;
-            pixel.r += pixel.g;
-
-            for (const auto c : algo::range(header.channel_count))
-            {
-                prev_pixel[c] += pixel[c];
-                image.at(x, y)[c] = prev_pixel[c];
-                image.at(x, y)[c] += y > 0 ? image.at(x, y - 1)[c] : 0;
-            }
-            if (!use_alpha)
-                image.at(x, y).a = 0xFF;
-        }
-    }
-}
-
 static void read_image(
     io::BaseByteStream &input_stream, res::Image &image, const Header &header)
 {
@@ -103,20 +65,51 @@ static void read_image(
     size_t block_count = (header.image_height - 1) / header.block_height + 1;
     input_stream.skip(4 * block_count);
 
+    // gather each channel into one plane, then undo the prediction for the
+    // whole image at once
+    std::vector<bstr> planes(header.channel_count);
     LzssDecompressor decompressor;
     for (const auto y
         : algo::range(0, header.image_height, header.block_height))
     {
-        std::vector<std::unique_ptr<BlockInfo>> channel_data;
-        for (const auto channel : algo::range(header.channel_count))
+        const auto row_count
+            = std::min(header.block_height, header.image_height - y);
+        const auto plane_size = header.image_width * row_count;
+        for (auto &plane : planes)
         {
-            auto block_info = std::make_unique<BlockInfo>(input_stream);
-            if (!block_info->mark)
-                block_info->decompress(decompressor, header);
-            channel_data.push_back(std::move(block_info));
+            BlockInfo block_info(input_stream);
+            if (!block_info.mark)
+                block_info.decompress(decompressor, header);
+            if (block_info.data.size() < plane_size)
+                throw err::BadDataSizeError();
+            plane += block_info.data.substr(0, plane_size);
         }
-        load_pixel_block_row(image, std::move(channel_data), header, y);
     }
+
+    for (const auto c : algo::range(header.channel_count))
+    {
+        res::scatter_channel(
+            image,
+            c,
+            planes[c].get<u8>(),
+            planes[c].size(),
+            header.image_width);
+    }
+
+    // blue and red are stored relative to green
+    for (auto &pixel : image)
+    {
+        pixel.b += pixel.g;
+        pixel.r += pixel.g;
+    }
+
+    for (const auto c : algo::range(header.channel_count))
+    {
+        res::apply_horizontal_delta(image, c, res::DeltaKind::Add);
+        res::apply_vertical_delta(image, c, res::DeltaKind::Add);
+    }
+    if (header.channel_count != 4)
+        res::fill_channel(image, 3, 0xFF);
 }
 
 res::Image Tlg5Decoder::decode(io::File &file)
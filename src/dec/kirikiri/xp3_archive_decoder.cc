@@ -16,6 +16,8 @@
 // along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
 
 #include "dec/kirikiri/xp3_archive_decoder.h"
+#include <algorithm>
+#include "algo/crypt/adler32.h"
 #include "algo/locale.h"
 #include "algo/pack/zlib.h"
 #include "algo/range.h"
@@ -76,6 +78,10 @@ static const bstr segm_chunk_magic = "segm"_b;
 static const bstr adlr_chunk_magic = "adlr"_b;
 static const bstr time_chunk_magic = "time"_b;
 
+// plugins tend to leave up to the first 0x13 bytes of each file as they are
+static const size_t min_probe_size = 0x14;
+static const size_t max_probe_count = 3;
+
 static int detect_version(io::BaseByteStream &input_stream)
 {
     if (input_stream.seek(19).read_le<u32>() == 1)
@@ -287,6 +293,144 @@ std::unique_ptr<io::File> Xp3ArchiveDecoder::read_file_impl(
     return std::make_unique<io::File>(entry->path, data);
 }
 
+static void write_string(
+    io::BaseByteStream &output_stream, const std::string &str)
+{
+    output_stream.write_le<u32>(str.size());
+    output_stream.write(str);
+}
+
+static std::string read_string(io::BaseByteStream &input_stream)
+{
+    return input_stream.read(input_stream.read_le<u32>()).str();
+}
+
+bool Xp3ArchiveDecoder::serialize_meta(
+    const dec::ArchiveMeta &m, io::BaseByteStream &output_stream) const
+{
+    output_stream.write_le<u32>(m.entries.size());
+    for (const auto &e : m.entries)
+    {
+        const auto entry = static_cast<const CustomArchiveEntry*>(e.get());
+        write_string(output_stream, entry->path.str());
+
+        output_stream.write_le<u32>(entry->info_chunk->flags);
+        output_stream.write_le<u64>(entry->info_chunk->file_size_orig);
+        output_stream.write_le<u64>(entry->info_chunk->file_size_comp);
+        write_string(output_stream, entry->info_chunk->name);
+
+        output_stream.write_le<u32>(entry->segm_chunks.size());
+        for (const auto &segm_chunk : entry->segm_chunks)
+        {
+            output_stream.write_le<u32>(segm_chunk->flags);
+            output_stream.write_le<u64>(segm_chunk->offset);
+            output_stream.write_le<u64>(segm_chunk->size_orig);
+            output_stream.write_le<u64>(segm_chunk->size_comp);
+        }
+
+        output_stream.write_le<u32>(entry->adlr_chunk->key);
+
+        output_stream.write<u8>(entry->time_chunk != nullptr);
+        if (entry->time_chunk)
+            output_stream.write_le<u64>(entry->time_chunk->timestamp);
+    }
+    return true;
+}
+
+std::unique_ptr<dec::ArchiveMeta> Xp3ArchiveDecoder::deserialize_meta(
+    io::File &input_file, io::BaseByteStream &input_stream) const
+{
+    auto meta = std::make_unique<CustomArchiveMeta>();
+    meta->decrypt_func = plugin_manager.get()
+        .create_decrypt_func(input_file.path);
+
+    const auto entry_count = input_stream.read_le<u32>();
+    for (const auto i : algo::range(entry_count))
+    {
+        auto entry = std::make_unique<CustomArchiveEntry>();
+        entry->path = read_string(input_stream);
+
+        entry->info_chunk = std::make_unique<InfoChunk>();
+        entry->info_chunk->flags = input_stream.read_le<u32>();
+        entry->info_chunk->file_size_orig = input_stream.read_le<u64>();
+        entry->info_chunk->file_size_comp = input_stream.read_le<u64>();
+        entry->info_chunk->name = read_string(input_stream);
+
+        const auto segm_chunk_count = input_stream.read_le<u32>();
+        for (const auto j : algo::range(segm_chunk_count))
+        {
+            auto segm_chunk = std::make_unique<SegmChunk>();
+            segm_chunk->flags = input_stream.read_le<u32>();
+            segm_chunk->offset = input_stream.read_le<u64>();
+            segm_chunk->size_orig = input_stream.read_le<u64>();
+            segm_chunk->size_comp = input_stream.read_le<u64>();
+            entry->segm_chunks.push_back(std::move(segm_chunk));
+        }
+
+        entry->adlr_chunk = std::make_unique<AdlrChunk>();
+        entry->adlr_chunk->key = input_stream.read_le<u32>();
+
+        if (input_stream.read<u8>())
+        {
+            entry->time_chunk = std::make_unique<TimeChunk>();
+            entry->time_chunk->timestamp = input_stream.read_le<u64>();
+        }
+
+        meta->entries.push_back(std::move(entry));
+    }
+    return std::move(meta);
+}
+
+bool Xp3ArchiveDecoder::is_plugin_match(
+    const Logger &logger,
+    io::File &input_file,
+    const dec::ArchiveMeta &m) const
+{
+    // the adlr chunk holds the checksum of the plain file contents. Tiny files
+    // often decrypt the same under several plugins, so check a few of the
+    // smallest entries that are large enough to tell them apart - that also
+    // spares decrypting huge files once per candidate plugin
+    std::vector<const CustomArchiveEntry*> entries;
+    for (const auto &e : m.entries)
+    {
+        const auto entry = static_cast<const CustomArchiveEntry*>(e.get());
+        if (entry->info_chunk->file_size_orig)
+            entries.push_back(entry);
+    }
+    if (entries.empty())
+        return false;
+
+    std::sort(
+        entries.begin(),
+        entries.end(),
+        [](const CustomArchiveEntry *a, const CustomArchiveEntry *b)
+        {
+            return a->info_chunk->file_size_orig
+                < b->info_chunk->file_size_orig;
+        });
+
+    auto probes_start = std::find_if(
+        entries.begin(),
+        entries.end(),
+        [](const CustomArchiveEntry *entry)
+        {
+            return entry->info_chunk->file_size_orig >= min_probe_size;
+        });
+    if (probes_start == entries.end())
+        probes_start = entries.end() - 1;
+    const auto probes_end = probes_start + std::min<size_t>(
+        max_probe_count, entries.end() - probes_start);
+
+    for (auto it = probes_start; it != probes_end; ++it)
+    {
+        const auto data = read_file_impl(logger, input_file, m, **it)
+            ->stream.seek(0).read_to_eof();
+        if (algo::crypt::adler32(data) != (*it)->adlr_chunk->key)
+            return false;
+    }
+    return true;
+}
+
 std::vector<std::string> Xp3ArchiveDecoder::get_linked_formats() const
 {
     return {"kirikiri/tlg"};
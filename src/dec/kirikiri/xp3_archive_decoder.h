@@ -44,6 +44,19 @@ namespace kirikiri {
             const ArchiveMeta &m,
             const ArchiveEntry &e) const override;
 
+        bool serialize_meta(
+            const ArchiveMeta &m,
+            io::BaseByteStream &output_stream) const override;
+
+        std::unique_ptr<ArchiveMeta> deserialize_meta(
+            io::File &input_file,
+            io::BaseByteStream &input_stream) const override;
+
+        bool is_plugin_match(
+            const Logger &logger,
+            io::File &input_file,
+            const ArchiveMeta &meta) const override;
+
     public:
         PluginManager<Xp3Plugin> plugin_manager;
     };
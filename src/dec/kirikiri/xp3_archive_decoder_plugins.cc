@@ -16,19 +16,18 @@
 // along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
 
 #include "dec/kirikiri/xp3_archive_decoder.h"
+#include "algo/crypt/xor.h"
 #include "algo/ptr.h"
 #include "algo/range.h"
+#include "asset_cache.h"
 #include "dec/kirikiri/cxdec.h"
-#include "io/program_path.h"
 
 using namespace au;
 using namespace au::dec::kirikiri;
 
 static bstr read_etc_file(const std::string &name)
 {
-    const auto path = io::get_assets_dir_path() / "xp3" / name;
-    io::File file(path, io::FileMode::Read);
-    return file.stream.seek(0).read_to_eof();
+    return AssetCache::read_asset(io::path("xp3") / name);
 }
 
 static Xp3Plugin create_simple_plugin(const Xp3DecryptFunc &xp3_decrypt_func)
@@ -52,8 +51,7 @@ Xp3ArchiveDecoder::Xp3ArchiveDecoder()
         "xor", "Basic XOR encryption",
         create_simple_plugin([](bstr &data, u32 key)
         {
-            for (const auto i : algo::range(data.size()))
-                data[i] ^= key;
+            algo::crypt::xor_constant(data.get<u8>(), data.size(), key);
         }));
 
     plugin_manager.add(
@@ -181,6 +179,7 @@ Xp3ArchiveDecoder::Xp3ArchiveDecoder()
         create_cxdec_plugin(
             0x23C, 0x60F, {2,0,1}, {1,5,0,3,2,7,6,4}, {4,5,2,1,0,3}));
 
+    plugin_manager.enable_auto_detection();
     add_arg_parser_decorator(
         plugin_manager.create_arg_parser_decorator(
             "Selects XP3 decryption routine."));
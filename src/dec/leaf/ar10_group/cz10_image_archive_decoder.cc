@@ -23,6 +23,7 @@
 #include "enc/png/png_image_encoder.h"
 #include "err.h"
 #include "io/memory_byte_stream.h"
+#include "res/image_kernels.h"
 
 using namespace au;
 using namespace au::dec::leaf;
@@ -136,13 +137,18 @@ std::unique_ptr<io::File> Cz10ImageArchiveDecoder::read_file_impl(
     if (entry->channels != 4)
         throw err::UnsupportedChannelCountError(entry->channels);
 
+    if (data.size() < entry->width * entry->height * entry->channels)
+        throw err::BadDataSizeError();
+
     res::Image image(entry->width, entry->height);
-    const auto *data_ptr = data.get<const u8>();
-    for (const auto y : algo::range(entry->height))
     for (const auto c : algo::range(entry->channels))
-    for (const auto x : algo::range(entry->width))
     {
-        image.at(x, y)[c] = *data_ptr++;
+        res::scatter_channel(
+            image,
+            c,
+            data.get<const u8>() + c * entry->width,
+            data.size() - c * entry->width,
+            entry->width * entry->channels);
     }
     const auto encoder = enc::png::PngImageEncoder();
     return encoder.encode(logger, image, entry->path);
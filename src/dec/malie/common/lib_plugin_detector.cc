@@ -0,0 +1,96 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#include "dec/malie/common/lib_plugin_detector.h"
+#include "algo/crypt/camellia.h"
+#include "algo/range.h"
+#include "io/memory_byte_stream.h"
+
+using namespace au;
+using namespace au::dec::malie::common;
+
+namespace
+{
+    struct Candidate final
+    {
+        LibPlugin plugin;
+        std::unique_ptr<algo::crypt::Camellia> camellia;
+    };
+}
+
+struct LibPluginDetector::Priv final
+{
+    bstr magic;
+    u32 magic_block;
+    std::vector<Candidate> candidates;
+};
+
+LibPluginDetector::LibPluginDetector(
+    const std::vector<LibPlugin> &plugins, const bstr &magic) : p(new Priv)
+{
+    p->magic = magic;
+    p->magic_block = io::MemoryByteStream(magic).read_be<u32>();
+    for (const auto &plugin : plugins)
+    {
+        Candidate candidate;
+        candidate.plugin = plugin;
+        if (plugin.key.size())
+        {
+            candidate.camellia
+                = std::make_unique<algo::crypt::Camellia>(plugin.key);
+        }
+        p->candidates.push_back(std::move(candidate));
+    }
+}
+
+LibPluginDetector::~LibPluginDetector()
+{
+}
+
+const LibPlugin *LibPluginDetector::detect(
+    io::BaseByteStream &input_stream) const
+{
+    const auto header = input_stream.seek(0).read(
+        std::min<uoff_t>(input_stream.size(), 16));
+
+    u32 input_block[4];
+    u32 output_block[4];
+    const auto is_encryptable = header.size() == 16;
+    if (is_encryptable)
+    {
+        io::MemoryByteStream header_stream(header);
+        for (const auto i : algo::range(4))
+            input_block[i] = header_stream.read_le<u32>();
+    }
+
+    for (const auto &candidate : p->candidates)
+    {
+        if (!candidate.camellia)
+        {
+            if (header.size() >= p->magic.size()
+                && header.substr(0, p->magic.size()) == p->magic)
+                return &candidate.plugin;
+            continue;
+        }
+        if (!is_encryptable)
+            continue;
+        candidate.camellia->decrypt_block_128(0, input_block, output_block);
+        if (output_block[0] == p->magic_block)
+            return &candidate.plugin;
+    }
+    return nullptr;
+}
@@ -0,0 +1,47 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <memory>
+#include "dec/malie/common/lib_plugin.h"
+#include "io/base_byte_stream.h"
+
+namespace au {
+namespace dec {
+namespace malie {
+namespace common {
+
+    // Prepares Camellia contexts for all the plugins up front, so that
+    // telling which key the input uses takes one 16-byte read and a single
+    // block decryption per plugin.
+    class LibPluginDetector final
+    {
+    public:
+        LibPluginDetector(
+            const std::vector<LibPlugin> &plugins, const bstr &magic);
+        ~LibPluginDetector();
+
+        // Returns nullptr if no plugin decrypts the input to the magic.
+        const LibPlugin *detect(io::BaseByteStream &input_stream) const;
+
+    private:
+        struct Priv;
+        std::unique_ptr<Priv> p;
+    };
+
+} } } }
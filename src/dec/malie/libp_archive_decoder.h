@@ -19,6 +19,7 @@
 
 #include "dec/base_archive_decoder.h"
 #include "dec/malie/common/lib_plugin.h"
+#include "dec/malie/common/lib_plugin_detector.h"
 #include "plugin_manager.h"
 
 namespace au {
@@ -46,6 +47,9 @@ namespace malie {
 
     public:
         PluginManager<common::LibPlugin> plugin_manager;
+
+    private:
+        std::unique_ptr<common::LibPluginDetector> plugin_detector;
     };
 
 } } }
@@ -35,14 +35,7 @@ namespace
 
 bool LibuArchiveDecoder::is_recognized_impl(io::File &input_file) const
 {
-    for (const auto &plugin : plugin_manager.get_all())
-    {
-        common::CamelliaStream camellia_stream(input_file.stream, plugin.key);
-        const auto maybe_magic = camellia_stream.seek(0).read(4);
-        if (maybe_magic == magic)
-            return true;
-    }
-    return false;
+    return plugin_detector->detect(input_file.stream) != nullptr;
 }
 
 std::unique_ptr<dec::ArchiveMeta> LibuArchiveDecoder::read_meta_impl(
@@ -51,9 +44,13 @@ std::unique_ptr<dec::ArchiveMeta> LibuArchiveDecoder::read_meta_impl(
     auto meta = std::make_unique<CustomArchiveMeta>();
 
     const auto maybe_magic = input_file.stream.seek(0).read(magic.size());
-    meta->plugin = maybe_magic == magic
-        ? plugin_manager.get("noop")
-        : plugin_manager.get();
+    const auto detected_plugin = plugin_detector->detect(input_file.stream);
+    if (maybe_magic == magic)
+        meta->plugin = plugin_manager.get("noop");
+    else if (plugin_manager.is_set() || !detected_plugin)
+        meta->plugin = plugin_manager.get();
+    else
+        meta->plugin = *detected_plugin;
 
     common::CamelliaStream camellia_stream(input_file.stream, meta->plugin.key);
     camellia_stream.seek(magic.size());
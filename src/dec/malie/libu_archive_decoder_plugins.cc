@@ -24,6 +24,8 @@ using namespace au::dec::malie;
 LibuArchiveDecoder::LibuArchiveDecoder()
 {
     common::add_common_lib_plugins(plugin_manager);
+    plugin_detector = std::make_unique<common::LibPluginDetector>(
+        plugin_manager.get_all(), "LIBU"_b);
 
     add_arg_parser_decorator(
         plugin_manager.create_arg_parser_decorator(
@@ -168,12 +168,14 @@ res::Image DdsImageDecoder::decode_impl(
     std::unique_ptr<res::Image> image(nullptr);
     if (header->pixel_format.flags & DDPF_FOURCC)
     {
-        if (header->pixel_format.four_cc == magic_dxt1)
-            image = decode_dxt1(input_file.stream, width, height);
-        else if (header->pixel_format.four_cc == magic_dxt3)
-            image = decode_dxt3(input_file.stream, width, height);
-        else if (header->pixel_format.four_cc == magic_dxt5)
-            image = decode_dxt5(input_file.stream, width, height);
+        const auto four_cc = header->pixel_format.four_cc;
+        io::SpanReader input(input_file.stream);
+        if (four_cc == magic_dxt1)
+            image = decode_dxt1(input, width, height);
+        else if (four_cc == magic_dxt3)
+            image = decode_dxt3(input, width, height);
+        else if (four_cc == magic_dxt5)
+            image = decode_dxt5(input, width, height);
         else
         {
             throw err::NotSupportedError(algo::format(
@@ -26,14 +26,22 @@ static std::unique_ptr<res::Image> create_image(
     return std::make_unique<res::Image>((width + 3) & ~3, (height + 3) & ~3);
 }
 
-static void decode_dxt1_block(
-    io::BaseByteStream &input_stream, res::Pixel output_colors[4][4])
+static inline u32 read_le_u24(const u8 *input_ptr)
+{
+    return input_ptr[0] | (input_ptr[1] << 8) | (input_ptr[2] << 16);
+}
+
+static inline u32 read_le_u32(const u8 *input_ptr)
+{
+    return read_le_u24(input_ptr) | (static_cast<u32>(input_ptr[3]) << 24);
+}
+
+static inline void decode_dxt1_block(
+    const u8 *input_ptr, res::Pixel *output_ptr, const size_t stride)
 {
     res::Pixel colors[4];
-    const auto tmp = input_stream.read(4);
-    const auto *tmp_ptr = tmp.get<const u8>();
-    colors[0] = res::read_pixel<res::PixelFormat::BGR565>(tmp_ptr);
-    colors[1] = res::read_pixel<res::PixelFormat::BGR565>(tmp_ptr);
+    colors[0] = res::read_pixel<res::PixelFormat::BGR565>(input_ptr);
+    colors[1] = res::read_pixel<res::PixelFormat::BGR565>(input_ptr);
     const auto transparent
         = colors[0].b <= colors[1].b
         && colors[0].g <= colors[1].g
@@ -54,115 +62,128 @@ static void decode_dxt1_block(
         }
     }
 
-    auto lookup = input_stream.read_le<u32>();
+    auto lookup = read_le_u32(input_ptr);
     for (const auto y : algo::range(4))
-    for (const auto x : algo::range(4))
     {
-        const auto index = lookup & 3;
-        output_colors[y][x] = colors[index];
-        lookup >>= 2;
+        for (const auto x : algo::range(4))
+        {
+            output_ptr[x] = colors[lookup & 3];
+            lookup >>= 2;
+        }
+        output_ptr += stride;
     }
 }
 
-static void decode_dxt5_block(
-    io::BaseByteStream &input_stream, u8 output_alpha[4][4])
+static inline void decode_dxt3_alpha_block(
+    const u8 *input_ptr, res::Pixel *output_ptr, const size_t stride)
 {
-    u8 alpha[8];
-    alpha[0] = input_stream.read<u8>();
-    alpha[1] = input_stream.read<u8>();
+    for (const auto y : algo::range(4))
+    {
+        for (const auto x : algo::range(0, 4, 2))
+        {
+            const auto b = *input_ptr++;
+            output_ptr[x + 0].a = b & 0xF0;
+            output_ptr[x + 1].a = (b & 0x0F) << 4;
+        }
+        output_ptr += stride;
+    }
+}
 
+static inline void decode_dxt5_alpha_block(
+    const u8 *input_ptr, res::Pixel *output_ptr, const size_t stride)
+{
+    u32 alpha[8];
+    alpha[0] = input_ptr[0];
+    alpha[1] = input_ptr[1];
     if (alpha[0] > alpha[1])
     {
         for (const auto i : algo::range(2, 8))
-            alpha[i] = ((8. - i) * alpha[0] + ((i - 1.) * alpha[1])) / 7.;
+            alpha[i] = ((8 - i) * alpha[0] + (i - 1) * alpha[1]) / 7;
     }
     else
     {
         for (const auto i : algo::range(2, 6))
-            alpha[i] = ((6. - i) * alpha[0] + ((i - 1.) * alpha[1])) / 5.;
+            alpha[i] = ((6 - i) * alpha[0] + (i - 1) * alpha[1]) / 5;
         alpha[6] = 0;
         alpha[7] = 255;
     }
 
+    // each 24-bit group of indices covers two rows
     for (const auto i : algo::range(2))
     {
-        u32 lookup = input_stream.read<u8>();
-        lookup |= input_stream.read<u8>() << 8;
-        lookup |= input_stream.read<u8>() << 16;
-        for (const auto j : algo::range(8))
+        auto lookup = read_le_u24(input_ptr + 2 + i * 3);
+        for (const auto y : algo::range(2))
         {
-            const auto index = lookup & 7;
-            const auto pos = i * 8 + j;
-            const auto x = pos % 4;
-            const auto y = pos / 4;
-            lookup >>= 3;
-            output_alpha[y][x] = alpha[index];
+            for (const auto x : algo::range(4))
+            {
+                output_ptr[x].a = alpha[lookup & 7];
+                lookup >>= 3;
+            }
+            output_ptr += stride;
         }
     }
 }
 
-std::unique_ptr<res::Image> dec::microsoft::dxt::decode_dxt1(
-    io::BaseByteStream &input_stream, size_t width, size_t height)
+template<typename T> static std::unique_ptr<res::Image> decode_blocks(
+    io::SpanReader &input,
+    const size_t width,
+    const size_t height,
+    const size_t block_size,
+    const T decode_block)
 {
     auto image = create_image(width, height);
-    for (const auto block_y : algo::range(0, height, 4))
-    for (const auto block_x : algo::range(0, width, 4))
+    const auto stride = image->width();
+    const auto blocks_per_row = image->width() / 4;
+    const auto block_rows = image->height() / 4;
+    const auto *input_ptr = input.read_ptr(
+        blocks_per_row * block_size * block_rows);
+
+    // Decoders already run on the unpacker's worker threads, so there's
+    // nothing to gain from spreading a single texture across more.
+    for (const auto block_y : algo::range(block_rows))
     {
-        res::Pixel colors[4][4];
-        decode_dxt1_block(input_stream, colors);
-        for (const auto y : algo::range(4))
-        for (const auto x : algo::range(4))
-            image->at(block_x + x, block_y + y) = colors[y][x];
+        auto *output_ptr = &image->at(0, block_y * 4);
+        for (const auto block_x : algo::range(blocks_per_row))
+        {
+            decode_block(input_ptr, output_ptr, stride);
+            input_ptr += block_size;
+            output_ptr += 4;
+        }
     }
     return image;
 }
 
-std::unique_ptr<res::Image> dec::microsoft::dxt::decode_dxt3(
-    io::BaseByteStream &input_stream, size_t width, size_t height)
+std::unique_ptr<res::Image> dec::microsoft::dxt::decode_dxt1(
+    io::SpanReader &input, const size_t width, const size_t height)
 {
-    auto image = create_image(width, height);
-    for (const auto block_y : algo::range(0, height, 4))
-    for (const auto block_x : algo::range(0, width, 4))
-    {
-        u8 alpha[4][4];
-        for (const auto y : algo::range(4))
-        for (const auto x : algo::range(0, 4, 2))
+    return decode_blocks(
+        input, width, height, 8,
+        [](const u8 *input_ptr, res::Pixel *output_ptr, const size_t stride)
         {
-            const auto b = input_stream.read<u8>();
-            alpha[y][x + 0] = b & 0xF0;
-            alpha[y][x + 1] = (b & 0x0F) << 4;
-        }
+            decode_dxt1_block(input_ptr, output_ptr, stride);
+        });
+}
 
-        res::Pixel colors[4][4];
-        decode_dxt1_block(input_stream, colors);
-        for (const auto y : algo::range(4))
-        for (const auto x : algo::range(4))
+std::unique_ptr<res::Image> dec::microsoft::dxt::decode_dxt3(
+    io::SpanReader &input, const size_t width, const size_t height)
+{
+    return decode_blocks(
+        input, width, height, 16,
+        [](const u8 *input_ptr, res::Pixel *output_ptr, const size_t stride)
         {
-            colors[y][x].a = alpha[y][x];
-            image->at(block_x + x, block_y + y) = colors[y][x];
-        }
-    }
-    return image;
+            decode_dxt1_block(input_ptr + 8, output_ptr, stride);
+            decode_dxt3_alpha_block(input_ptr, output_ptr, stride);
+        });
 }
 
 std::unique_ptr<res::Image> dec::microsoft::dxt::decode_dxt5(
-    io::BaseByteStream &input_stream, size_t width, size_t height)
+    io::SpanReader &input, const size_t width, const size_t height)
 {
-    auto image = create_image(width, height);
-    for (const auto block_y : algo::range(0, height, 4))
-    for (const auto block_x : algo::range(0, width, 4))
-    {
-        u8 alpha[4][4];
-        decode_dxt5_block(input_stream, alpha);
-
-        res::Pixel colors[4][4];
-        decode_dxt1_block(input_stream, colors);
-        for (const auto y : algo::range(4))
-        for (const auto x : algo::range(4))
+    return decode_blocks(
+        input, width, height, 16,
+        [](const u8 *input_ptr, res::Pixel *output_ptr, const size_t stride)
         {
-            colors[y][x].a = alpha[y][x];
-            image->at(block_x + x, block_y + y) = colors[y][x];
-        }
-    }
-    return image;
+            decode_dxt1_block(input_ptr + 8, output_ptr, stride);
+            decode_dxt5_alpha_block(input_ptr, output_ptr, stride);
+        });
 }
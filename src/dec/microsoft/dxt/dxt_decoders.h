@@ -17,7 +17,7 @@
 
 #pragma once
 
-#include "io/base_byte_stream.h"
+#include "io/span_reader.h"
 #include "res/image.h"
 
 namespace au {
@@ -25,19 +25,17 @@ namespace dec {
 namespace microsoft {
 namespace dxt {
 
+    // The input must hold at least as many blocks as needed to cover the
+    // image dimensions rounded up to a multiple of 4; they are consumed
+    // from its current position.
+
     std::unique_ptr<res::Image> decode_dxt1(
-        io::BaseByteStream &input_stream,
-        const size_t width,
-        const size_t height);
+        io::SpanReader &input, const size_t width, const size_t height);
 
     std::unique_ptr<res::Image> decode_dxt3(
-        io::BaseByteStream &input_stream,
-        const size_t width,
-        const size_t height);
+        io::SpanReader &input, const size_t width, const size_t height);
 
     std::unique_ptr<res::Image> decode_dxt5(
-        io::BaseByteStream &input_stream,
-        const size_t width,
-        const size_t height);
+        io::SpanReader &input, const size_t width, const size_t height);
 
 } } } }
@@ -25,6 +25,11 @@ using namespace au::dec::microsoft;
 static const bstr riff_magic = "RIFF"_b;
 static const bstr wave_magic = "WAVE"_b;
 
+bool WavAudioDecoder::is_canonical_format() const
+{
+    return true;
+}
+
 bool WavAudioDecoder::is_recognized_impl(io::File &input_file) const
 {
     return input_file.stream.seek(0).read(riff_magic.size()) == riff_magic
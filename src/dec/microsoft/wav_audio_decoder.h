@@ -26,6 +26,7 @@ namespace microsoft {
     class WavAudioDecoder final : public BaseAudioDecoder
     {
     protected:
+        bool is_canonical_format() const override;
         bool is_recognized_impl(io::File &input_file) const override;
         res::Audio decode_impl(
             const Logger &logger, io::File &input_file) const override;
@@ -130,15 +130,19 @@ res::Image GtfImageDecoder::decode_impl(
 
     input_file.stream.seek(spec.header_size);
 
+    const auto width = spec.width;
+    const auto height = spec.height;
+
     const auto format = static_cast<CellGcmTextureType>(spec.flags & 0x9F);
+    io::SpanReader input(input_file.stream);
     if (format == CellGcmTextureType::CompressedDxt1)
-        return *decode_dxt1(input_file.stream, spec.width, spec.height);
+        return *decode_dxt1(input, width, height);
 
     if (format == CellGcmTextureType::CompressedDxt23)
-        return *decode_dxt3(input_file.stream, spec.width, spec.height);
+        return *decode_dxt3(input, width, height);
 
     if (format == CellGcmTextureType::CompressedDxt45)
-        return *decode_dxt5(input_file.stream, spec.width, spec.height);
+        return *decode_dxt5(input, width, height);
 
     throw err::NotSupportedError("Only DXT-packed textures are supported");
 }
@@ -114,6 +114,11 @@ static res::Image decode(
     return res::Image(width, height, data, format);
 }
 
+bool PngImageDecoder::is_canonical_format() const
+{
+    return true;
+}
+
 bool PngImageDecoder::is_recognized_impl(io::File &input_file) const
 {
     return input_file.stream.read(magic.size()) == magic;
@@ -36,6 +36,7 @@ namespace png {
             ChunkHandler chunk_handler) const;
 
     protected:
+        bool is_canonical_format() const override;
         bool is_recognized_impl(io::File &input_file) const override;
         res::Image decode_impl(
             const Logger &logger, io::File &input_file) const override;
@@ -16,6 +16,7 @@
 // along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
 
 #include "dec/qlie/mt.h"
+#include <algorithm>
 #include "algo/range.h"
 
 using namespace au;
@@ -62,47 +63,62 @@ void CustomMersenneTwister::xor_state(const bstr &data)
         p->state[i++] ^= *data_ptr++;
 }
 
-u32 CustomMersenneTwister::get_next_integer()
+static void regenerate(u32 state[], int &mti)
 {
+    static const u32 mag01[2] = {0x0ul, matrix_a};
     u32 y;
-    static u32 mag01[2] = {0x0ul, matrix_a};
-
-    if (p->mti >= n)
-    {
-        int kk;
-
-        if (p->mti == n + 1)
-            init_state(p->state, 5489ul, p->mti);
-
-        for (kk = 0; kk < n - m; kk++)
-        {
-            y = (p->state[kk] & upper_mask)
-                | ((p->state[kk + 1] & lower_mask) >> 1);
+    int kk;
 
-            p->state[kk]
-                = p->state[kk + m] ^ y ^ mag01[p->state[kk + 1] & 0x1ul];
-        }
+    if (mti == n + 1)
+        init_state(state, 5489ul, mti);
 
-        for (; kk < n - 1; kk++)
-        {
-            y = (p->state[kk] & upper_mask)
-                | ((p->state[kk + 1] & lower_mask) >> 1);
-
-            p->state[kk]
-                = p->state[kk + (m - n)] ^ y ^ mag01[p->state[kk + 1] & 0x1ul];
-        }
+    for (kk = 0; kk < n - m; kk++)
+    {
+        y = (state[kk] & upper_mask) | ((state[kk + 1] & lower_mask) >> 1);
+        state[kk] = state[kk + m] ^ y ^ mag01[state[kk + 1] & 0x1ul];
+    }
 
-        y = (p->state[n - 1] & upper_mask) | ((p->state[0] & lower_mask) >> 1);
-        p->state[n - 1] = p->state[m - 1] ^ y ^ mag01[p->state[n - 1] & 0x1ul];
-        p->mti = 0;
+    for (; kk < n - 1; kk++)
+    {
+        y = (state[kk] & upper_mask) | ((state[kk + 1] & lower_mask) >> 1);
+        state[kk] = state[kk + (m - n)] ^ y ^ mag01[state[kk + 1] & 0x1ul];
     }
 
-    y = p->state[p->mti++];
+    y = (state[n - 1] & upper_mask) | ((state[0] & lower_mask) >> 1);
+    state[n - 1] = state[m - 1] ^ y ^ mag01[state[n - 1] & 0x1ul];
+    mti = 0;
+}
 
+static inline u32 temper(u32 y)
+{
     y ^= (y >> 11);
     y ^= (y << 7) & 0x9C4F88E3ul;
     y ^= (y << 15) & 0xE7F70000ul;
     y ^= (y >> 18);
-
     return y;
 }
+
+u32 CustomMersenneTwister::get_next_integer()
+{
+    if (p->mti >= n)
+        regenerate(p->state, p->mti);
+    return temper(p->state[p->mti++]);
+}
+
+void CustomMersenneTwister::get_next_integers(u32 *output, size_t count)
+{
+    // Tempering a run of state words has no dependencies between them, so
+    // it's done one whole run at a time.
+    while (count)
+    {
+        if (p->mti >= n)
+            regenerate(p->state, p->mti);
+        const auto chunk_size = std::min<size_t>(count, n - p->mti);
+        const auto state_ptr = p->state + p->mti;
+        for (const auto i : algo::range(chunk_size))
+            output[i] = temper(state_ptr[i]);
+        p->mti += chunk_size;
+        output += chunk_size;
+        count -= chunk_size;
+    }
+}
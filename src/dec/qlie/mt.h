@@ -33,6 +33,9 @@ namespace qlie {
         void xor_state(const bstr &data);
         u32 get_next_integer();
 
+        // Same as calling get_next_integer() count times.
+        void get_next_integers(u32 *output, const size_t count);
+
     private:
         struct Priv;
         std::unique_ptr<Priv> p;
@@ -16,17 +16,19 @@
 // along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
 
 #include "dec/qlie/pack_archive_decoder.h"
+#include <array>
 #include "algo/binary.h"
 #include "algo/locale.h"
 #include "algo/ptr.h"
 #include "algo/range.h"
 #include "algo/str.h"
+#include "asset_cache.h"
 #include "dec/borland/tpf0_decoder.h"
 #include "dec/microsoft/exe_archive_decoder.h"
 #include "dec/qlie/mt.h"
 #include "err.h"
 #include "io/file_system.h"
-#include "io/memory_byte_stream.h"
+#include "io/span_reader.h"
 
 using namespace au;
 using namespace au::dec::qlie;
@@ -49,6 +51,12 @@ namespace
         bool compressed;
         u32 seed;
     };
+
+    struct ExternalKeys final
+    {
+        bstr fkey;
+        bstr exe_key;
+    };
 }
 
 static size_t get_magic_start(const io::BaseByteStream &input_stream)
@@ -120,21 +128,21 @@ static void decrypt_file_data_with_external_keys(
     mt.xor_state(meta.key1);
     mt.xor_state(meta.key2);
 
-    std::vector<u64> table(16);
+    // 16 table entries, 9 skipped values, the mutator and the table index
+    std::array<u32, 16 * 2 + 9 + 2 + 1> keystream;
+    mt.get_next_integers(keystream.data(), keystream.size());
+
+    std::array<u64, 16> table;
     for (const auto i : algo::range(table.size()))
     {
         table[i]
-            = mt.get_next_integer()
-            | (static_cast<u64>(mt.get_next_integer()) << 32);
+            = keystream[i * 2]
+            | (static_cast<u64>(keystream[i * 2 + 1]) << 32);
     }
-    for (const auto i : algo::range(9))
-        mt.get_next_integer();
 
-    u64 mutator
-        = mt.get_next_integer()
-        | (static_cast<u64>(mt.get_next_integer()) << 32);
+    u64 mutator = keystream[41] | (static_cast<u64>(keystream[42]) << 32);
 
-    auto table_index = mt.get_next_integer() % table.size();
+    auto table_index = keystream[43] % table.size();
     auto data_ptr = algo::make_ptr(data.get<u64>(), data.size() / 8);
     while (data_ptr.left())
     {
@@ -172,7 +180,7 @@ static bstr decompress(const bstr &input, const size_t output_size)
     bstr output(output_size);
     auto output_ptr = algo::make_ptr(output);
 
-    io::MemoryByteStream input_stream(input);
+    io::SpanReader input_stream(input);
 
     if (input_stream.read(compression_magic.size()) != compression_magic)
     {
@@ -254,7 +262,8 @@ static bstr get_fkey(const io::path &input_path)
     return file.stream.seek(0).read_to_eof();
 }
 
-static bstr get_exe_key(const Logger &logger, const io::path &input_path)
+static bstr get_exe_key_uncached(
+    const Logger &logger, const io::path &input_path)
 {
     io::File exe_file(input_path, io::FileMode::Read);
     const auto exe_decoder = dec::microsoft::ExeArchiveDecoder();
@@ -287,6 +296,54 @@ static bstr get_exe_key(const Logger &logger, const io::path &input_path)
     return ticon_content.substr(6, 256);
 }
 
+// Getting to the key means unpacking the executable's resources and
+// decoding a Delphi form, which is worth doing only once per run.
+static bstr get_exe_key(const Logger &logger, const io::path &input_path)
+{
+    return *AssetCache::get<bstr>(
+        "qlie/exe-key:" + AssetCache::identify_file(input_path),
+        [&]()
+        {
+            return std::make_shared<const bstr>(
+                get_exe_key_uncached(logger, input_path));
+        });
+}
+
+// All archives of a game look for their keys in the same directory.
+static std::shared_ptr<const ExternalKeys> find_external_keys(
+    const Logger &logger, const io::path &dir)
+{
+    return AssetCache::get_transient<ExternalKeys>(
+        "qlie/external-keys:" + io::absolute(dir).str(),
+        [&]()
+        {
+            auto keys = std::make_shared<ExternalKeys>();
+            logger.info("Searching for archive keys in %s...\n", dir.c_str());
+            for (const auto &path : io::recursive_directory_range(dir))
+            {
+                if (!io::is_regular_file(path))
+                    continue;
+                if (path.has_extension("fkey") && keys->fkey.empty())
+                {
+                    keys->fkey = get_fkey(path);
+                    logger.info("Found fkey in %s\n", path.c_str());
+                }
+                if (path.has_extension("exe") && keys->exe_key.empty())
+                {
+                    try
+                    {
+                        keys->exe_key = get_exe_key(logger, path);
+                        logger.info("Found .exe key in %s\n", path.c_str());
+                    }
+                    catch (...)
+                    {
+                    }
+                }
+            }
+            return keys;
+        });
+}
+
 PackArchiveDecoder::PackArchiveDecoder()
 {
     add_arg_parser_decorator(
@@ -335,29 +392,12 @@ std::unique_ptr<dec::ArchiveMeta> PackArchiveDecoder::read_meta_impl(
 
         if (meta->key1.empty() || meta->key2.empty())
         {
-            const auto dir = input_file.path.parent().parent();
-            logger.info("Searching for archive keys in %s...\n", dir.c_str());
-            for (const auto &path : io::recursive_directory_range(dir))
-            {
-                if (!io::is_regular_file(path))
-                    continue;
-                if (path.has_extension("fkey") && meta->key1.empty())
-                {
-                    meta->key1 = get_fkey(path);
-                    logger.info("Found fkey in %s\n", path.c_str());
-                }
-                if (path.has_extension("exe") && meta->key2.empty())
-                {
-                    try
-                    {
-                        meta->key2 = get_exe_key(logger, path);
-                        logger.info("Found .exe key in %s\n", path.c_str());
-                    }
-                    catch (...)
-                    {
-                    }
-                }
-            }
+            const auto keys = find_external_keys(
+                logger, input_file.path.parent().parent());
+            if (meta->key1.empty())
+                meta->key1 = keys->fkey;
+            if (meta->key2.empty())
+                meta->key2 = keys->exe_key;
         }
         if (meta->key1.empty())
             logger.info("fkey not found\n");
@@ -370,7 +410,7 @@ std::unique_ptr<dec::ArchiveMeta> PackArchiveDecoder::read_meta_impl(
     const auto table_offset = input_file.stream.read_le<u64>();
     const auto table_size = get_magic_start(input_file.stream) - table_offset;
     input_file.stream.seek(table_offset);
-    io::MemoryByteStream table_stream(input_file.stream, table_size);
+    io::SpanReader table_stream(input_file.stream, table_size);
 
     u32 seed = 0;
     table_stream.seek(0);
@@ -18,6 +18,7 @@
 #include "dec/registry.h"
 #include <algorithm>
 #include <map>
+#include <stack>
 #include "dec/idecoder.h"
 #include "err.h"
 
@@ -58,6 +59,30 @@ std::shared_ptr<IDecoder>
     return p->decoder_map[name]();
 }
 
+std::set<std::string> Registry::get_linked_decoder_names(
+    const IDecoder &decoder) const
+{
+    std::set<std::string> known_formats;
+    std::vector<std::shared_ptr<IDecoder>> linked_decoders;
+    std::stack<const IDecoder*> decoders_to_inspect;
+    decoders_to_inspect.push(&decoder);
+    while (!decoders_to_inspect.empty())
+    {
+        const auto decoder_to_inspect = decoders_to_inspect.top();
+        decoders_to_inspect.pop();
+        for (const auto &format : decoder_to_inspect->get_linked_formats())
+        {
+            if (known_formats.find(format) != known_formats.end())
+                continue;
+            known_formats.insert(format);
+            auto linked_decoder = create_decoder(format);
+            decoders_to_inspect.push(linked_decoder.get());
+            linked_decoders.push_back(std::move(linked_decoder));
+        }
+    }
+    return known_formats;
+}
+
 void Registry::add_decoder(const std::string &name, DecoderCreator creator)
 {
     if (has_decoder(name))
@@ -19,6 +19,7 @@
 
 #include <functional>
 #include <memory>
+#include <set>
 #include <vector>
 #include <string>
 
@@ -42,6 +43,8 @@ namespace dec {
         bool has_decoder(const std::string &name) const;
         void add_decoder(const std::string &name, DecoderCreator creator);
         std::shared_ptr<IDecoder> create_decoder(const std::string &name) const;
+        std::set<std::string> get_linked_decoder_names(
+            const IDecoder &decoder) const;
 
     private:
         Registry();
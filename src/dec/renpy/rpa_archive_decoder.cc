@@ -310,4 +310,38 @@ std::unique_ptr<io::File> RpaArchiveDecoder::read_file_impl(
     return std::make_unique<io::File>(entry->path, entry->prefix + data);
 }
 
+bool RpaArchiveDecoder::serialize_meta(
+    const dec::ArchiveMeta &m, io::BaseByteStream &output_stream) const
+{
+    output_stream.write_le<u32>(m.entries.size());
+    for (const auto &e : m.entries)
+    {
+        const auto entry = static_cast<const CustomArchiveEntry*>(e.get());
+        output_stream.write_le<u32>(entry->path.str().size());
+        output_stream.write(entry->path.str());
+        output_stream.write_le<u32>(entry->prefix.size());
+        output_stream.write(entry->prefix);
+        output_stream.write_le<u64>(entry->offset);
+        output_stream.write_le<u64>(entry->size);
+    }
+    return true;
+}
+
+std::unique_ptr<dec::ArchiveMeta> RpaArchiveDecoder::deserialize_meta(
+    io::File &input_file, io::BaseByteStream &input_stream) const
+{
+    auto meta = std::make_unique<ArchiveMeta>();
+    const auto entry_count = input_stream.read_le<u32>();
+    for (const auto i : algo::range(entry_count))
+    {
+        auto entry = std::make_unique<CustomArchiveEntry>();
+        entry->path = input_stream.read(input_stream.read_le<u32>()).str();
+        entry->prefix = input_stream.read(input_stream.read_le<u32>());
+        entry->offset = input_stream.read_le<u64>();
+        entry->size = input_stream.read_le<u64>();
+        meta->entries.push_back(std::move(entry));
+    }
+    return meta;
+}
+
 static auto _ = dec::register_decoder<RpaArchiveDecoder>("renpy/rpa");
@@ -37,6 +37,14 @@ namespace renpy {
             io::File &input_file,
             const ArchiveMeta &m,
             const ArchiveEntry &e) const override;
+
+        bool serialize_meta(
+            const ArchiveMeta &m,
+            io::BaseByteStream &output_stream) const override;
+
+        std::unique_ptr<ArchiveMeta> deserialize_meta(
+            io::File &input_file,
+            io::BaseByteStream &input_stream) const override;
     };
 
 } } }
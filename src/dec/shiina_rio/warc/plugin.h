@@ -45,7 +45,7 @@ namespace warc {
         std::array<u32, 5> initial_crypt_base_keys;
 
         bstr logo_data;
-        std::shared_ptr<res::Image> region_image;
+        std::shared_ptr<const res::Image> region_image;
 
         bstr crc_crypt_source;
         std::unique_ptr<BaseExtraCrypt> extra_crypt;
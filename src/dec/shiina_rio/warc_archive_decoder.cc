@@ -18,6 +18,7 @@
 #include "dec/shiina_rio/warc_archive_decoder.h"
 #include <set>
 #include "algo/str.h"
+#include "asset_cache.h"
 #include "dec/shiina_rio/warc/decompress.h"
 #include "dec/shiina_rio/warc/decrypt.h"
 #include "err.h"
@@ -33,10 +34,10 @@ namespace
     struct CustomArchiveMeta final : dec::ArchiveMeta
     {
         CustomArchiveMeta(
-            const std::shared_ptr<warc::Plugin> plugin,
+            const std::shared_ptr<const warc::Plugin> plugin,
             const int warc_version);
 
-        const std::shared_ptr<warc::Plugin> plugin;
+        const std::shared_ptr<const warc::Plugin> plugin;
         const int warc_version;
     };
 
@@ -49,7 +50,7 @@ namespace
 }
 
 CustomArchiveMeta::CustomArchiveMeta(
-    const std::shared_ptr<warc::Plugin> plugin, const int warc_version)
+    const std::shared_ptr<const warc::Plugin> plugin, const int warc_version)
     : plugin(plugin), warc_version(warc_version)
 {
 }
@@ -62,7 +63,11 @@ bool WarcArchiveDecoder::is_recognized_impl(io::File &input_file) const
 std::unique_ptr<dec::ArchiveMeta> WarcArchiveDecoder::read_meta_impl(
     const Logger &logger, io::File &input_file) const
 {
-    const auto plugin = plugin_manager.get()();
+    // plugins load their tables and images from the assets directory, so
+    // they're shared by all the archives of a game
+    const auto plugin = AssetCache::get<warc::Plugin>(
+        "shiina_rio/warc/" + plugin_manager.get_selected_name(),
+        plugin_manager.get());
     input_file.stream.seek(magic.size());
     const int warc_version = 100
         * algo::from_string<float>(input_file.stream.read(3).str());
@@ -16,30 +16,34 @@
 // along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
 
 #include "dec/shiina_rio/warc_archive_decoder.h"
+#include "asset_cache.h"
 #include "dec/png/png_image_decoder.h"
 #include "dec/shiina_rio/warc/decrypt.h"
 #include "io/file.h"
 #include "io/memory_byte_stream.h"
-#include "io/program_path.h"
 
 using namespace au;
 using namespace au::dec::shiina_rio;
 
 static bstr read_etc_file(const std::string &name)
 {
-    const auto path = io::get_assets_dir_path() / "shiina_rio" / name;
-    io::File file(path, io::FileMode::Read);
-    return file.stream.seek(0).read_to_eof();
+    return AssetCache::read_asset(io::path("shiina_rio") / name);
 }
 
-static std::shared_ptr<res::Image> read_etc_image(const std::string &name)
+static std::shared_ptr<const res::Image> read_etc_image(
+    const std::string &name)
 {
-    Logger dummy_logger;
-    dummy_logger.mute();
-    io::File tmp_file("tmp.png", read_etc_file(name));
-    const auto png_decoder = dec::png::PngImageDecoder();
-    return std::make_shared<res::Image>(
-        png_decoder.decode(dummy_logger, tmp_file));
+    return AssetCache::get<res::Image>(
+        "shiina_rio/" + name,
+        [&]()
+        {
+            Logger dummy_logger;
+            dummy_logger.mute();
+            io::File tmp_file("tmp.png", read_etc_file(name));
+            const auto png_decoder = dec::png::PngImageDecoder();
+            return std::make_shared<const res::Image>(
+                png_decoder.decode(dummy_logger, tmp_file));
+        });
 }
 
 namespace
@@ -16,8 +16,7 @@
 // along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
 
 #include "dec/team_shanghai_alice/crypt.h"
-#include "algo/range.h"
-#include "io/memory_byte_stream.h"
+#include "algo/crypt/xor.h"
 
 using namespace au;
 using namespace au::dec::team_shanghai_alice;
@@ -30,12 +29,15 @@ bool DecryptorContext::operator ==(const DecryptorContext &other) const
         && limit == other.limit;
 }
 
-static void decrypt(
-    io::BaseByteStream &input_stream,
-    io::BaseByteStream &output_stream,
-    const DecryptorContext &context)
+bstr au::dec::team_shanghai_alice::decrypt(
+    const bstr &input, const DecryptorContext &context)
 {
-    int left = input_stream.size();
+    // Whatever isn't covered by the blocks stays as is.
+    bstr output(input);
+    const auto input_ptr = input.get<const u8>();
+    const auto output_ptr = output.get<u8>();
+
+    int left = input.size();
     size_t current_block_size = context.block_size;
     u8 key = context.key;
 
@@ -45,41 +47,20 @@ static void decrypt(
     shift += (left & 1);
     left -= shift;
 
-    while (left > 0 && output_stream.pos() < context.limit)
+    size_t pos = 0;
+    while (left > 0 && pos < context.limit)
     {
         if (left < static_cast<int>(current_block_size))
             current_block_size = left;
-        auto input_block = input_stream.read(current_block_size);
-        auto *input_block_ptr = input_block.get<const char>();
-        bstr output_block(current_block_size);
-        for (const auto j : algo::range(2))
-        {
-            u8 *output_block_ptr = &output_block[current_block_size - j - 1];
-            for (const auto i : algo::range((current_block_size - j + 1) >> 1))
-            {
-                *output_block_ptr = *input_block_ptr++ ^ key;
-                output_block_ptr -= 2;
-                key += context.step;
-            }
-        }
-
-        output_stream.write(output_block);
+        key = algo::crypt::xor_incrementing_reverse_interleaved(
+            input_ptr + pos,
+            output_ptr + pos,
+            current_block_size,
+            key,
+            context.step);
+        pos += current_block_size;
         left -= current_block_size;
     }
 
-    left += shift;
-    left = std::min(left, static_cast<int>(
-        input_stream.size() - input_stream.pos()));
-    if (left > 0)
-        output_stream.write(input_stream.read(left));
-    output_stream.seek(0);
-}
-
-bstr au::dec::team_shanghai_alice::decrypt(
-    const bstr &input, const DecryptorContext &context)
-{
-    io::MemoryByteStream input_stream(input);
-    io::MemoryByteStream output_stream;
-    ::decrypt(input_stream, output_stream, context);
-    return output_stream.read_to_eof();
+    return output;
 }
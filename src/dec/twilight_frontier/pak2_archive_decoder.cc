@@ -31,9 +31,9 @@ using namespace au::dec::twilight_frontier;
 static void decrypt(bstr &buffer, u32 mt_seed, u8 a, u8 b, u8 delta)
 {
     auto mt = algo::crypt::MersenneTwister::Improved(mt_seed);
+    mt->xor_stream(buffer.get<u8>(), buffer.size());
     for (const auto i : algo::range(buffer.size()))
     {
-        buffer[i] ^= mt->next_u32();
         buffer[i] ^= a;
         a += b;
         b += delta;
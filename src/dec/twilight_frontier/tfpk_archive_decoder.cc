@@ -19,6 +19,7 @@
 #include <map>
 #include "algo/crypt/rsa.h"
 #include "algo/format.h"
+#include "algo/key_trial.h"
 #include "algo/locale.h"
 #include "algo/pack/zlib.h"
 #include "algo/range.h"
@@ -70,7 +71,7 @@ namespace
             decrypt(std::basic_string<u8> input);
 
         io::BaseByteStream &input_stream;
-        std::unique_ptr<algo::crypt::Rsa> rsa;
+        std::shared_ptr<const algo::crypt::Rsa> rsa;
     };
 }
 
@@ -136,6 +137,20 @@ static const std::vector<algo::crypt::RsaKey> rsa_keys({
     },
 });
 
+// Setting up the OpenSSL key objects is the costly part of a trial, so
+// it's done once per process.
+static const std::vector<std::shared_ptr<const algo::crypt::Rsa>> &get_rsas()
+{
+    static const auto rsas = []()
+    {
+        std::vector<std::shared_ptr<const algo::crypt::Rsa>> ret;
+        for (const auto &rsa_key : rsa_keys)
+            ret.push_back(std::make_shared<const algo::crypt::Rsa>(rsa_key));
+        return ret;
+    }();
+    return rsas;
+}
+
 RsaReader::RsaReader(io::BaseByteStream &input_stream)
     : input_stream(input_stream)
 {
@@ -145,18 +160,20 @@ RsaReader::RsaReader(io::BaseByteStream &input_stream)
         input_stream.pos(),
         [&]() { test_chunk = input_stream.read(0x40); });
 
-    for (const auto &rsa_key : rsa_keys)
-    {
-        algo::crypt::Rsa tester(rsa_key);
-        try
+    // A single public decryption takes microseconds; not worth threads.
+    const auto &rsas = get_rsas();
+    const auto match = algo::find_first_match(
+        rsas,
+        [&](const std::shared_ptr<const algo::crypt::Rsa> &candidate)
         {
-            tester.decrypt(test_chunk);
-            rsa = std::make_unique<algo::crypt::Rsa>(rsa_key);
-            return;
-        }
-        catch (...)
-        {
-        }
+            candidate->decrypt(test_chunk);
+            return true;
+        },
+        1);
+    if (match)
+    {
+        rsa = *match;
+        return;
     }
 
     // no encryption - TH14.5 English patch.
@@ -22,6 +22,7 @@
 #include "dec/png/png_image_decoder.h"
 #include "enc/png/png_image_encoder.h"
 #include "err.h"
+#include "io/span_reader.h"
 
 using namespace au;
 using namespace au::dec::yuzusoft;
@@ -119,12 +120,12 @@ static BasicInfo read_basic_info(io::BaseByteStream &input_stream)
     return ret;
 }
 
-static unsigned long read_variable_integer(
-    io::BaseByteStream &input_stream, const size_t bytes)
+template<typename T> static unsigned long read_variable_integer(
+    T &input_stream, const size_t bytes)
 {
     size_t ret = 0;
     for (const auto i : algo::range(bytes))
-        ret |= input_stream.read<u8>() << (i * 8);
+        ret |= input_stream.template read<u8>() << (i * 8);
     return ret;
 }
 
@@ -165,9 +166,11 @@ static std::vector<unsigned long> read_array(io::BaseByteStream &input_stream)
     const auto n = input_stream.read<u8>() - 0xC;
     const auto entry_count = read_variable_integer(input_stream, n);
     const auto entry_size = input_stream.read<u8>() - 0xC;
+    io::SpanReader table_reader(input_stream, entry_count * entry_size);
     std::vector<unsigned long> ret;
+    ret.reserve(entry_count);
     for (const auto i : algo::range(entry_count))
-        ret.push_back(read_variable_integer(input_stream, entry_size));
+        ret.push_back(read_variable_integer(table_reader, entry_size));
     return ret;
 }
 
@@ -0,0 +1,302 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#include "flow/archive_lister.h"
+#include <map>
+#include "algo/format.h"
+#include "flow/decoder_pool.h"
+#include "flow/json.h"
+#include "dec/idecoder.h"
+#include "dec/idecoder_visitor.h"
+
+using namespace au;
+using namespace au::flow;
+
+static const auto max_depth = 10;
+
+namespace
+{
+    struct ArchiveDecoderExtractor final : public dec::IDecoderVisitor
+    {
+        void visit(const dec::BaseArchiveDecoder &decoder) override
+        {
+            archive_decoder = &decoder;
+        }
+
+        void visit(const dec::BaseFileDecoder &decoder) override {}
+        void visit(const dec::BaseImageDecoder &decoder) override {}
+        void visit(const dec::BaseAudioDecoder &decoder) override {}
+
+        const dec::BaseArchiveDecoder *archive_decoder = nullptr;
+    };
+}
+
+struct ArchiveLister::Priv final
+{
+    Priv(
+        const Logger &logger,
+        std::ostream &output,
+        const dec::Registry &registry,
+        const PathFilter &path_filter,
+        const ListingFormat format,
+        const bool recursive,
+        const std::vector<std::string> &arguments,
+        const std::set<std::string> &decoders_to_check);
+
+    std::string guess_decoder(
+        io::File &input_file,
+        const std::set<std::string> &decoders_to_check,
+        const bool is_nested) const;
+
+    bool list(
+        io::File &input_file,
+        const io::path &archive_path,
+        const std::set<std::string> &decoders_to_check,
+        const size_t depth) const;
+
+    void print_entry(
+        const io::path &archive_path,
+        const std::string &decoder_name,
+        const dec::ArchiveEntry &entry) const;
+
+    Logger logger;
+    std::ostream &output;
+    mutable DecoderPool decoder_pool;
+    const PathFilter &path_filter;
+    const ListingFormat format;
+    const bool recursive;
+    const std::set<std::string> decoders_to_check;
+};
+
+ArchiveLister::Priv::Priv(
+    const Logger &logger,
+    std::ostream &output,
+    const dec::Registry &registry,
+    const PathFilter &path_filter,
+    const ListingFormat format,
+    const bool recursive,
+    const std::vector<std::string> &arguments,
+    const std::set<std::string> &decoders_to_check) :
+        logger(logger),
+        output(output),
+        decoder_pool(registry, arguments),
+        path_filter(path_filter),
+        format(format),
+        recursive(recursive),
+        decoders_to_check(decoders_to_check)
+{
+}
+
+std::string ArchiveLister::Priv::guess_decoder(
+    io::File &input_file,
+    const std::set<std::string> &decoders_to_check,
+    const bool is_nested) const
+{
+    std::vector<std::string> matching_decoders;
+    for (const auto &name : decoders_to_check)
+        if (decoder_pool.get_recognizer(name)->is_recognized(input_file))
+            matching_decoders.push_back(name);
+
+    if (matching_decoders.size() == 1)
+        return matching_decoders[0];
+
+    if (is_nested)
+        return "";
+
+    if (matching_decoders.empty())
+    {
+        logger.err(
+            "%s: not recognized by any decoder.\n", input_file.path.c_str());
+    }
+    else
+    {
+        logger.warn(
+            "%s: file was recognized by multiple decoders.\n",
+            input_file.path.c_str());
+        for (const auto &name : matching_decoders)
+            logger.warn("- " + name + "\n");
+        logger.warn("Please provide --dec and proceed manually.\n");
+    }
+    return "";
+}
+
+bool ArchiveLister::Priv::list(
+    io::File &input_file,
+    const io::path &archive_path,
+    const std::set<std::string> &decoders_to_check,
+    const size_t depth) const
+{
+    const auto is_nested = depth > 0;
+    const auto decoder_name
+        = guess_decoder(input_file, decoders_to_check, is_nested);
+    if (decoder_name.empty())
+        return is_nested;
+
+    ArchiveDecoderExtractor extractor;
+    decoder_pool.get_recognizer(decoder_name)->accept(extractor);
+    if (!extractor.archive_decoder)
+    {
+        if (!is_nested)
+        {
+            logger.warn(
+                "%s: not an archive (recognized as %s).\n",
+                archive_path.c_str(),
+                decoder_name.c_str());
+        }
+        return true;
+    }
+
+    const auto decoder = decoder_pool.get_decoder(decoder_name);
+    decoder->accept(extractor);
+    const auto meta = extractor.archive_decoder->read_meta(logger, input_file);
+
+    auto nested_decoders = decoder_pool.get_linked_decoder_names(*decoder);
+    if (is_nested)
+    {
+        nested_decoders.insert(
+            decoders_to_check.begin(), decoders_to_check.end());
+    }
+    const auto should_recurse = recursive
+        && !nested_decoders.empty()
+        && depth + 1 < max_depth;
+
+    auto result = true;
+    for (const auto &entry : meta->entries)
+    {
+        if (!path_filter.accepts(entry->path))
+            continue;
+        print_entry(archive_path, decoder_name, *entry);
+        if (!should_recurse)
+            continue;
+        try
+        {
+            const auto nested_file = extractor.archive_decoder->read_file(
+                logger, input_file, *meta, *entry);
+            if (!nested_file)
+                continue;
+            result &= list(
+                *nested_file,
+                archive_path / entry->path,
+                nested_decoders,
+                depth + 1);
+        }
+        catch (const std::exception &e)
+        {
+            logger.err(
+                "%s: error reading %s (%s)\n",
+                archive_path.c_str(),
+                entry->path.c_str(),
+                e.what());
+            result = false;
+        }
+    }
+    return result;
+}
+
+void ArchiveLister::Priv::print_entry(
+    const io::path &archive_path,
+    const std::string &decoder_name,
+    const dec::ArchiveEntry &entry) const
+{
+    std::map<std::string, uoff_t> numbers;
+    if (const auto plain_entry
+        = dynamic_cast<const dec::PlainArchiveEntry*>(&entry))
+    {
+        numbers["offset"] = plain_entry->offset;
+        numbers["size"] = plain_entry->size;
+    }
+    else if (const auto compressed_entry
+        = dynamic_cast<const dec::CompressedArchiveEntry*>(&entry))
+    {
+        numbers["offset"] = compressed_entry->offset;
+        numbers["size_comp"] = compressed_entry->size_comp;
+        numbers["size_orig"] = compressed_entry->size_orig;
+    }
+
+    std::string line;
+    if (format == ListingFormat::Jsonl)
+    {
+        line = algo::format(
+            "{\"archive\":\"%s\",\"decoder\":\"%s\",\"path\":\"%s\"",
+            json::escape(archive_path.str()).c_str(),
+            json::escape(decoder_name).c_str(),
+            json::escape(entry.path.str()).c_str());
+        for (const auto &kv : numbers)
+        {
+            line += algo::format(
+                ",\"%s\":%llu",
+                kv.first.c_str(),
+                static_cast<unsigned long long>(kv.second));
+        }
+        line += "}";
+    }
+    else
+    {
+        line = algo::format(
+            "%s\t%s\t%s",
+            archive_path.c_str(),
+            decoder_name.c_str(),
+            entry.path.c_str());
+        for (const auto &kv : numbers)
+        {
+            line += algo::format(
+                "\t%s=%llu",
+                kv.first.c_str(),
+                static_cast<unsigned long long>(kv.second));
+        }
+    }
+    output << line << "\n";
+}
+
+ArchiveLister::ArchiveLister(
+    const Logger &logger,
+    std::ostream &output,
+    const dec::Registry &registry,
+    const PathFilter &path_filter,
+    const ListingFormat format,
+    const bool recursive,
+    const std::vector<std::string> &arguments,
+    const std::set<std::string> &decoders_to_check) :
+        p(new Priv(
+            logger,
+            output,
+            registry,
+            path_filter,
+            format,
+            recursive,
+            arguments,
+            decoders_to_check))
+{
+}
+
+ArchiveLister::~ArchiveLister()
+{
+}
+
+bool ArchiveLister::list(io::File &input_file) const
+{
+    try
+    {
+        return p->list(input_file, input_file.path, p->decoders_to_check, 0);
+    }
+    catch (const std::exception &e)
+    {
+        p->logger.err(
+            "%s: error listing (%s)\n", input_file.path.c_str(), e.what());
+        return false;
+    }
+}
@@ -0,0 +1,60 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <memory>
+#include <ostream>
+#include <set>
+#include "dec/registry.h"
+#include "flow/path_filter.h"
+#include "io/file.h"
+#include "logger.h"
+
+namespace au {
+namespace flow {
+
+    enum class ListingFormat : u8
+    {
+        Text,
+        Jsonl,
+    };
+
+    // Prints archive entries using only read_meta, without extracting
+    // anything. Nested archives are read on demand when recursing.
+    class ArchiveLister final
+    {
+    public:
+        ArchiveLister(
+            const Logger &logger,
+            std::ostream &output,
+            const dec::Registry &registry,
+            const PathFilter &path_filter,
+            const ListingFormat format,
+            const bool recursive,
+            const std::vector<std::string> &arguments,
+            const std::set<std::string> &decoders_to_check);
+        ~ArchiveLister();
+
+        bool list(io::File &input_file) const;
+
+    private:
+        struct Priv;
+        std::unique_ptr<Priv> p;
+    };
+
+} }
@@ -17,14 +17,24 @@
 
 #include "flow/cli_facade.h"
 #include <algorithm>
+#include <fstream>
+#include <iostream>
 #include <map>
+#include <set>
 #include "algo/range.h"
 #include "algo/str.h"
 #include "arg_parser.h"
+#include "dec/archive_meta_cache.h"
 #include "dec/idecoder.h"
 #include "dec/registry.h"
+#include "flow/archive_lister.h"
+#include "flow/daemon.h"
+#include "flow/file_saver_archive.h"
 #include "flow/file_saver_hdd.h"
+#include "flow/journal.h"
 #include "flow/parallel_unpacker.h"
+#include "flow/path_filter.h"
+#include "io/file_byte_stream.h"
 #include "io/file_system.h"
 #include "version.h"
 #include "virtual_file_system.h"
@@ -38,22 +48,64 @@ namespace
     {
         std::string decoder;
         io::path output_dir;
+        io::path output_archive;
+        io::path journal_path;
+        io::path daemon_socket;
+        io::path client_socket;
+        bool resume;
+        ArchiveFormat output_archive_format;
         std::vector<io::path> input_paths;
         bool overwrite;
+        bool deduplicate;
         bool enable_nested_decoding;
         bool enable_virtual_file_system;
         bool should_show_help;
         bool should_show_version;
         bool should_list_decoders;
+        bool should_list_entries;
+        bool list_nested_entries;
+        ListingFormat listing_format;
         int verbosity = 3;
         unsigned int thread_count;
+        PathFilter path_filter;
     };
 }
 
+// Starts with the largest inputs, so that a single huge archive picked up
+// last doesn't keep one thread busy long after the others are done.
+static void sort_largest_first(std::vector<io::path> &paths)
+{
+    std::map<io::path, uoff_t> sizes;
+    for (const auto &path : paths)
+        sizes[path] = io::is_regular_file(path) ? io::file_size(path) : 0;
+    std::stable_sort(
+        paths.begin(),
+        paths.end(),
+        [&](const io::path &a, const io::path &b)
+        {
+            return sizes.at(a) > sizes.at(b);
+        });
+}
+
+static void register_input_directories(const std::vector<io::path> &paths)
+{
+    std::set<io::path> directories;
+    for (const auto &path : paths)
+        directories.insert(io::absolute(path).parent());
+    for (const auto &directory : directories)
+        VirtualFileSystem::register_directory(directory);
+}
+
 struct CliFacade::Priv final
 {
 public:
-    Priv(Logger &logger, const std::vector<std::string> &arguments);
+    Priv(
+        Logger &logger,
+        const std::vector<std::string> &arguments,
+        std::ostream &output,
+        TaskScheduler *task_scheduler,
+        DecoderPool *decoder_pool);
+
     int run() const;
 
 private:
@@ -61,17 +113,31 @@ private:
     void print_decoder_list() const;
     void print_cli_help() const;
     void parse_cli_options();
+    bool list_entries(const std::set<std::string> &available_decoders) const;
 
     Logger &logger;
     const std::vector<std::string> arguments;
+    std::ostream &output;
     const dec::Registry &registry;
+    TaskScheduler *task_scheduler;
+    DecoderPool *decoder_pool;
 
     ArgParser arg_parser;
     Options options;
 };
 
-CliFacade::Priv::Priv(Logger &logger, const std::vector<std::string> &arguments)
-    : logger(logger), arguments(arguments), registry(dec::Registry::instance())
+CliFacade::Priv::Priv(
+    Logger &logger,
+    const std::vector<std::string> &arguments,
+    std::ostream &output,
+    TaskScheduler *task_scheduler,
+    DecoderPool *decoder_pool)
+    : logger(logger),
+        arguments(arguments),
+        output(output),
+        registry(dec::Registry::instance()),
+        task_scheduler(task_scheduler),
+        decoder_pool(decoder_pool)
 {
     register_cli_options();
     arg_parser.parse(arguments);
@@ -163,6 +229,44 @@ void CliFacade::Priv::register_cli_options()
             "By default, the files are placed in current working directory. "
             "(Archives always create an intermediate directory.)");
 
+    arg_parser.register_flag({"--dedup"})
+        ->set_description(
+            "Stores output files with identical contents only once. "
+            "Duplicates are hard linked to the first copy, or stored as "
+            "hard link entries with --tar. Has no effect with --zip.");
+
+    arg_parser.register_switch({"--meta-cache"})
+        ->set_value_name("DIR")
+        ->set_description(
+            "Caches parsed archive tables in given directory, so that "
+            "subsequent runs over unchanged archives don't parse them "
+            "again. Only some archive formats support this.");
+
+    arg_parser.register_switch({"--journal"})
+        ->set_value_name("FILE")
+        ->set_description(
+            "Records extracted inputs and archive entries in given file.");
+
+    arg_parser.register_flag({"--resume"})
+        ->set_description(
+            "Skips inputs and archive entries recorded in the journal as "
+            "already extracted. Inputs are recognized by their path, size "
+            "and modification time, so unchanged inputs are skipped "
+            "entirely. Uses arc_unpacker.journal in the output directory "
+            "unless --journal is given.");
+
+    arg_parser.register_switch({"--tar"})
+        ->set_value_name("FILE")
+        ->set_description(
+            "Writes all output files into a single uncompressed tar archive "
+            "instead of separate files. Use - to write to standard output.");
+
+    arg_parser.register_switch({"--zip"})
+        ->set_value_name("FILE")
+        ->set_description(
+            "Writes all output files into a single store-only zip archive "
+            "instead of separate files. Use - to write to standard output.");
+
     {
         auto sw = arg_parser.register_switch({"-d", "--dec"})
             ->set_value_name("DECODER")
@@ -175,6 +279,22 @@ void CliFacade::Priv::register_cli_options()
     arg_parser.register_flag({"-l", "--list-decoders"})
         ->set_description("Lists available DECODER values.");
 
+    arg_parser.register_flag({"--list"})
+        ->set_description(
+            "Lists archive entries along with their offsets and sizes "
+            "instead of extracting them.");
+
+    arg_parser.register_switch({"--list-format"})
+        ->set_value_name("FORMAT")
+        ->set_description("Sets --list output format (defaults to text).")
+        ->add_possible_value("text")
+        ->add_possible_value("jsonl");
+
+    arg_parser.register_flag({"--list-nested"})
+        ->set_description(
+            "Makes --list descend into nested archives. "
+            "Nested archives are read, but not saved.");
+
     arg_parser.register_switch({"-t", "--threads"})
         ->set_value_name("NUM")
         ->set_description("Sets worker thread count.");
@@ -205,6 +325,41 @@ void CliFacade::Priv::register_cli_options()
     arg_parser.register_flag({"--no-vfs"})
         ->set_description("Disables virtual file system lookups.");
 
+    arg_parser.register_switch({"--include"})
+        ->set_value_name("PATTERN")
+        ->set_description(
+            "Extracts only archive entries matching given pattern. "
+            "Can be used multiple times. PATTERN is a glob (* doesn't cross "
+            "directories, ** does) matched against the entry path, or "
+            "against the file name if it has no slashes. Patterns starting "
+            "with regex: are regular expressions. Entries are filtered "
+            "before they're read, so nested archives need to be included "
+            "too in order to get to their contents.");
+
+    arg_parser.register_switch({"--exclude"})
+        ->set_value_name("PATTERN")
+        ->set_description(
+            "Skips archive entries matching given pattern. "
+            "Can be used multiple times.");
+
+    arg_parser.register_switch({"--files-from"})
+        ->set_value_name("FILE")
+        ->set_description(
+            "Extracts only archive entries whose paths are listed in given "
+            "file, one per line.");
+
+    arg_parser.register_switch({"--daemon"})
+        ->set_value_name("SOCKET")
+        ->set_description(
+            "Keeps running and serves jobs sent with --client through given "
+            "Unix socket, so that startup costs are paid only once.");
+
+    arg_parser.register_switch({"--client"})
+        ->set_value_name("SOCKET")
+        ->set_description(
+            "Sends the job to a daemon listening on given socket instead of "
+            "running it in this process.");
+
     arg_parser.register_flag({"--version"})
         ->set_description("Shows arc_unpacker version.");
 }
@@ -219,9 +374,20 @@ void CliFacade::Priv::parse_cli_options()
     options.should_list_decoders
         = arg_parser.has_flag("-l") || arg_parser.has_flag("--list-decoders");
 
+    options.should_list_entries = arg_parser.has_flag("--list");
+    options.list_nested_entries = arg_parser.has_flag("--list-nested");
+    options.listing_format = ListingFormat::Text;
+    if (arg_parser.has_switch("--list-format")
+        && arg_parser.get_switch("--list-format") == "jsonl")
+    {
+        options.listing_format = ListingFormat::Jsonl;
+    }
+
     options.overwrite
         = !arg_parser.has_flag("-r") && !arg_parser.has_flag("--rename");
 
+    options.deduplicate = arg_parser.has_flag("--dedup");
+
     if (arg_parser.has_flag("--no-color") || arg_parser.has_flag("--no-colors"))
         logger.disable_colors();
 
@@ -254,6 +420,46 @@ void CliFacade::Priv::parse_cli_options()
     else
         options.output_dir = "./";
 
+    if (arg_parser.has_switch("--meta-cache"))
+        dec::ArchiveMetaCache::enable(arg_parser.get_switch("--meta-cache"));
+
+    options.resume = arg_parser.has_flag("--resume");
+    if (arg_parser.has_switch("--journal"))
+        options.journal_path = arg_parser.get_switch("--journal");
+    else if (options.resume)
+        options.journal_path = options.output_dir / "arc_unpacker.journal";
+
+    if (arg_parser.has_switch("--daemon"))
+        options.daemon_socket = arg_parser.get_switch("--daemon");
+    if (arg_parser.has_switch("--client"))
+        options.client_socket = arg_parser.get_switch("--client");
+
+    if (arg_parser.has_switch("--tar"))
+    {
+        options.output_archive = arg_parser.get_switch("--tar");
+        options.output_archive_format = ArchiveFormat::Tar;
+    }
+    else if (arg_parser.has_switch("--zip"))
+    {
+        options.output_archive = arg_parser.get_switch("--zip");
+        options.output_archive_format = ArchiveFormat::Zip;
+    }
+
+    for (const auto &pattern : arg_parser.get_switches("--include"))
+        options.path_filter.add_include_pattern(pattern);
+    for (const auto &pattern : arg_parser.get_switches("--exclude"))
+        options.path_filter.add_exclude_pattern(pattern);
+    for (const auto &list_path : arg_parser.get_switches("--files-from"))
+    {
+        io::FileByteStream list_stream(list_path, io::FileMode::Read);
+        while (list_stream.left())
+        {
+            const auto line = list_stream.read_line().str();
+            if (!line.empty())
+                options.path_filter.add_included_path(line);
+        }
+    }
+
     if (arg_parser.has_switch("-d"))
         options.decoder = arg_parser.get_switch("-d");
     if (arg_parser.has_switch("--dec"))
@@ -272,6 +478,7 @@ void CliFacade::Priv::parse_cli_options()
             options.input_paths.push_back(stray);
         }
     }
+    sort_largest_first(options.input_paths);
 }
 
 int CliFacade::Priv::run() const
@@ -294,6 +501,16 @@ int CliFacade::Priv::run() const
         return 0;
     }
 
+    // the daemon rejects jobs that also ask for a server
+    if (!options.client_socket.str().empty())
+    {
+        return DaemonClient(logger, options.client_socket)
+            .run(remove_switch(arguments, "client"), output);
+    }
+
+    if (!options.daemon_socket.str().empty())
+        return DaemonServer(logger, options.daemon_socket).run();
+
     if (options.input_paths.size() < 1)
     {
         logger.err("Error: required more arguments.\n\n");
@@ -306,33 +523,128 @@ int CliFacade::Priv::run() const
         ? std::set<std::string>(name_list.begin(), name_list.end())
         : std::set<std::string>{options.decoder};
 
-    FileSaverHdd file_saver(options.output_dir, options.overwrite);
+    if (options.should_list_entries)
+        return list_entries(available_decoders) ? 0 : 1;
+
+    std::unique_ptr<std::ofstream> output_archive_stream;
+    std::unique_ptr<IFileSaver> file_saver;
+    if (options.output_archive.str().empty())
+    {
+        file_saver = std::make_unique<FileSaverHdd>(
+            options.output_dir, options.overwrite, options.deduplicate);
+    }
+    else if (options.output_archive.str() == "-")
+    {
+        // keep stdout clean for the archive; errors still go to stderr
+        logger.mute(Logger::MessageType::Summary);
+        logger.mute(Logger::MessageType::Info);
+        logger.mute(Logger::MessageType::Success);
+        logger.mute(Logger::MessageType::Debug);
+        file_saver = std::make_unique<FileSaverArchive>(
+            output, options.output_archive_format, options.deduplicate);
+    }
+    else
+    {
+        output_archive_stream = std::make_unique<std::ofstream>(
+            options.output_archive.str(), std::ios::binary);
+        if (!*output_archive_stream)
+        {
+            logger.err(
+                "Error: could not open %s for writing.\n",
+                options.output_archive.c_str());
+            return 1;
+        }
+        file_saver = std::make_unique<FileSaverArchive>(
+            *output_archive_stream,
+            options.output_archive_format,
+            options.deduplicate);
+    }
+
+    const auto journal = options.journal_path.str().empty()
+        ? std::make_unique<Journal>()
+        : std::make_unique<Journal>(options.journal_path, options.resume);
+
     ParallelUnpackerContext context(
         logger,
-        file_saver,
+        *file_saver,
         registry,
+        options.path_filter,
+        *journal,
         options.enable_nested_decoding,
         arguments,
         available_decoders);
 
-    ParallelUnpacker unpacker(context);
+    register_input_directories(options.input_paths);
+
+    const auto unpacker = task_scheduler && decoder_pool
+        ? std::make_unique<ParallelUnpacker>(
+            context, *task_scheduler, *decoder_pool)
+        : std::make_unique<ParallelUnpacker>(context);
     for (const auto &input_path : options.input_paths)
     {
-        unpacker.add_input_file(
+        unpacker->add_input_file(
             io::path(input_path).change_stem(input_path.stem() + "~").name(),
             [&]()
             {
-                VirtualFileSystem::register_directory(
-                    io::absolute(input_path).parent());
                 return std::make_shared<io::File>(
                     io::absolute(input_path), io::FileMode::Read);
-            });
+            },
+            journal->is_enabled() ? Journal::identify_input(input_path) : "");
     }
-    return unpacker.run(options.thread_count) ? 0 : 1;
+    return unpacker->run(options.thread_count) ? 0 : 1;
+}
+
+bool CliFacade::Priv::list_entries(
+    const std::set<std::string> &available_decoders) const
+{
+    // keep stdout clean for the listing; errors still go to stderr
+    Logger listing_logger(logger);
+    listing_logger.mute(Logger::MessageType::Info);
+    listing_logger.mute(Logger::MessageType::Success);
+    listing_logger.mute(Logger::MessageType::Debug);
+
+    const ArchiveLister lister(
+        listing_logger,
+        output,
+        registry,
+        options.path_filter,
+        options.listing_format,
+        options.list_nested_entries,
+        arguments,
+        available_decoders);
+
+    register_input_directories(options.input_paths);
+
+    auto result = true;
+    for (const auto &input_path : options.input_paths)
+    {
+        io::File input_file(io::absolute(input_path), io::FileMode::Read);
+        input_file.path = input_path;
+        result &= lister.list(input_file);
+    }
+    return result;
 }
 
 CliFacade::CliFacade(Logger &logger, const std::vector<std::string> &arguments)
-    : p(new Priv(logger, arguments))
+    : CliFacade(logger, arguments, std::cout)
+{
+}
+
+CliFacade::CliFacade(
+    Logger &logger,
+    const std::vector<std::string> &arguments,
+    std::ostream &output)
+    : p(new Priv(logger, arguments, output, nullptr, nullptr))
+{
+}
+
+CliFacade::CliFacade(
+    Logger &logger,
+    const std::vector<std::string> &arguments,
+    std::ostream &output,
+    TaskScheduler &task_scheduler,
+    DecoderPool &decoder_pool)
+    : p(new Priv(logger, arguments, output, &task_scheduler, &decoder_pool))
 {
 }
 
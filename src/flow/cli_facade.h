@@ -19,6 +19,7 @@
 
 #include <boost/filesystem/path.hpp>
 #include <memory>
+#include <ostream>
 #include <string>
 #include <vector>
 #include "logger.h"
@@ -26,6 +27,9 @@
 namespace au {
 namespace flow {
 
+    class DecoderPool;
+    class TaskScheduler;
+
     class CliFacade final
     {
     public:
@@ -33,6 +37,22 @@ namespace flow {
             Logger &logger,
             const std::vector<std::string> &arguments);
 
+        // Writes listings and archives streamed to "-" to given stream
+        // rather than to standard output.
+        CliFacade(
+            Logger &logger,
+            const std::vector<std::string> &arguments,
+            std::ostream &output);
+
+        // Unpacks on given scheduler and decoders, which must have been
+        // configured with the same arguments, rather than on its own.
+        CliFacade(
+            Logger &logger,
+            const std::vector<std::string> &arguments,
+            std::ostream &output,
+            TaskScheduler &task_scheduler,
+            DecoderPool &decoder_pool);
+
         ~CliFacade();
 
         int run() const;
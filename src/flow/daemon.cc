@@ -0,0 +1,466 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#include "flow/daemon.h"
+#include <map>
+#include <sstream>
+#include "algo/format.h"
+#include "algo/range.h"
+#include "asset_cache.h"
+#include "dec/archive_meta_cache.h"
+#include "err.h"
+#include "flow/cli_facade.h"
+#include "flow/decoder_pool.h"
+#include "flow/json.h"
+#include "flow/task_scheduler.h"
+#include "io/file_system.h"
+#include "virtual_file_system.h"
+
+#if !_WIN32
+    #include <cerrno>
+    #include <cstring>
+    #include <sys/socket.h>
+    #include <sys/stat.h>
+    #include <sys/un.h>
+    #include <unistd.h>
+#endif
+
+using namespace au;
+using namespace au::flow;
+
+#if !_WIN32
+    #ifdef MSG_NOSIGNAL
+        static const int send_flags = MSG_NOSIGNAL;
+    #else
+        static const int send_flags = 0;
+    #endif
+
+    namespace
+    {
+        class Socket final
+        {
+        public:
+            Socket();
+            ~Socket();
+
+            void bind(const io::path &socket_path);
+            void connect(const io::path &socket_path);
+            std::unique_ptr<Socket> accept();
+
+            std::string read_line();
+            void write(const std::string &data);
+
+            int get_fd() const;
+
+        private:
+            Socket(const int fd);
+
+            int fd;
+        };
+    }
+
+    static sockaddr_un make_address(const io::path &socket_path)
+    {
+        sockaddr_un address;
+        std::memset(&address, 0, sizeof(address));
+        address.sun_family = AF_UNIX;
+        const auto str = socket_path.str();
+        if (str.size() >= sizeof(address.sun_path))
+            throw err::GeneralError("Socket path is too long: " + str);
+        std::memcpy(address.sun_path, str.c_str(), str.size());
+        return address;
+    }
+
+    static err::GeneralError make_socket_error(const std::string &operation)
+    {
+        return err::GeneralError(algo::format(
+            "Could not %s socket: %s",
+            operation.c_str(),
+            std::strerror(errno)));
+    }
+
+    Socket::Socket() : fd(::socket(AF_UNIX, SOCK_STREAM, 0))
+    {
+        if (fd == -1)
+            throw make_socket_error("create");
+    }
+
+    Socket::Socket(const int fd) : fd(fd)
+    {
+    }
+
+    Socket::~Socket()
+    {
+        ::close(fd);
+    }
+
+    int Socket::get_fd() const
+    {
+        return fd;
+    }
+
+    // Removes a socket left behind by a daemon that is gone, and refuses
+    // to touch anything else.
+    static void remove_stale_socket(const io::path &socket_path)
+    {
+        struct stat info;
+        if (::lstat(socket_path.c_str(), &info) == -1)
+        {
+            if (errno == ENOENT)
+                return;
+            throw make_socket_error("inspect");
+        }
+        if (!S_ISSOCK(info.st_mode))
+        {
+            throw err::GeneralError(
+                "Refusing to replace " + socket_path.str()
+                + ", which is not a socket");
+        }
+
+        const auto address = make_address(socket_path);
+        Socket probe;
+        const auto result = ::connect(
+            probe.get_fd(),
+            reinterpret_cast<const sockaddr*>(&address),
+            sizeof(address));
+        if (result != -1)
+        {
+            throw err::GeneralError(
+                "Another daemon is already listening on " + socket_path.str());
+        }
+        if (errno != ECONNREFUSED)
+            throw make_socket_error("probe");
+        if (::unlink(socket_path.c_str()) == -1)
+            throw make_socket_error("remove stale");
+    }
+
+    void Socket::bind(const io::path &socket_path)
+    {
+        const auto address = make_address(socket_path);
+        remove_stale_socket(socket_path);
+        if (::bind(fd, reinterpret_cast<const sockaddr*>(&address),
+                sizeof(address)) == -1)
+        {
+            throw make_socket_error("bind");
+        }
+        if (::listen(fd, 16) == -1)
+            throw make_socket_error("listen on");
+    }
+
+    void Socket::connect(const io::path &socket_path)
+    {
+        const auto address = make_address(socket_path);
+        if (::connect(fd, reinterpret_cast<const sockaddr*>(&address),
+                sizeof(address)) == -1)
+        {
+            throw make_socket_error("connect to");
+        }
+    }
+
+    std::unique_ptr<Socket> Socket::accept()
+    {
+        while (true)
+        {
+            const auto client_fd = ::accept(fd, nullptr, nullptr);
+            if (client_fd != -1)
+                return std::unique_ptr<Socket>(new Socket(client_fd));
+            if (errno != EINTR)
+                throw make_socket_error("accept on");
+        }
+    }
+
+    std::string Socket::read_line()
+    {
+        std::string line;
+        char buffer[4096];
+        while (true)
+        {
+            const auto count = ::recv(fd, buffer, sizeof(buffer), 0);
+            if (count == -1 && errno == EINTR)
+                continue;
+            if (count == -1)
+                throw make_socket_error("read from");
+            if (count == 0)
+                return line;
+            line.append(buffer, count);
+            const auto pos = line.find('\n');
+            if (pos != std::string::npos)
+                return line.substr(0, pos);
+        }
+    }
+
+    void Socket::write(const std::string &data)
+    {
+        size_t written = 0;
+        while (written < data.size())
+        {
+            const auto count = ::send(
+                fd, data.data() + written, data.size() - written, send_flags);
+            if (count == -1 && errno == EINTR)
+                continue;
+            if (count == -1)
+                throw make_socket_error("write to");
+            written += count;
+        }
+    }
+#endif
+
+std::vector<std::string> flow::remove_switch(
+    const std::vector<std::string> &arguments, const std::string &name)
+{
+    std::vector<std::string> output;
+    for (auto it = arguments.begin(); it != arguments.end(); ++it)
+    {
+        const auto start = it->find_first_not_of('-');
+        if (start == 0 || start == std::string::npos)
+        {
+            output.push_back(*it);
+            continue;
+        }
+        const auto argument = it->substr(start);
+        if (argument == name)
+        {
+            if (it + 1 != arguments.end())
+                ++it;
+            continue;
+        }
+        if (argument.find(name + "=") != 0)
+            output.push_back(*it);
+    }
+    return output;
+}
+
+static std::string make_response(
+    const int exit_code, const std::string &output, const std::string &error)
+{
+    return algo::format(
+        "{\"exit_code\":%d,\"output\":\"%s\",\"error\":\"%s\"}\n",
+        exit_code,
+        json::escape(output).c_str(),
+        json::escape(error).c_str());
+}
+
+static const size_t max_decoder_pools = 16;
+
+struct DaemonServer::Priv final
+{
+    Priv(Logger &logger, const io::path &socket_path);
+    std::string serve(const std::string &request, bool &shutdown);
+    DecoderPool &get_decoder_pool(
+        const std::string &cwd, const std::vector<std::string> &arguments);
+
+    Logger &logger;
+    const io::path socket_path;
+
+    // kept warm across jobs, which are served one at a time
+    TaskScheduler task_scheduler;
+    std::map<std::string, std::unique_ptr<DecoderPool>> decoder_pools;
+};
+
+DaemonServer::Priv::Priv(Logger &logger, const io::path &socket_path)
+    : logger(logger), socket_path(io::absolute(socket_path))
+{
+}
+
+// Decoders are configured by the switches and may resolve relative paths
+// in them, so jobs that agree on both can share decoder instances.
+DecoderPool &DaemonServer::Priv::get_decoder_pool(
+    const std::string &cwd, const std::vector<std::string> &arguments)
+{
+    std::vector<std::string> switches;
+    std::string key = cwd;
+    for (const auto &argument : arguments)
+    {
+        if (argument.empty() || argument[0] != '-')
+            continue;
+        switches.push_back(argument);
+        key += '\n' + argument;
+    }
+
+    const auto it = decoder_pools.find(key);
+    if (it != decoder_pools.end())
+        return *it->second;
+    if (decoder_pools.size() >= max_decoder_pools)
+        decoder_pools.clear();
+    auto decoder_pool = std::make_unique<DecoderPool>(
+        dec::Registry::instance(), switches);
+    auto &result = *decoder_pool;
+    decoder_pools[key] = std::move(decoder_pool);
+    return result;
+}
+
+std::string DaemonServer::Priv::serve(
+    const std::string &request, bool &shutdown)
+{
+    const auto job = json::parse_flat_object(request);
+    if (job.strings.find("command") != job.strings.end())
+    {
+        if (job.strings.at("command") != "shutdown")
+            throw err::CorruptDataError("Unknown daemon command");
+        shutdown = true;
+        return make_response(0, "", "");
+    }
+
+    if (job.strings.find("cwd") == job.strings.end())
+        throw err::CorruptDataError("Job has no working directory");
+    const auto arguments_it = job.arrays.find("args");
+    const auto arguments = arguments_it == job.arrays.end()
+        ? std::vector<std::string>()
+        : arguments_it->second;
+    for (const auto &name : {"daemon", "client"})
+    {
+        // a nested server would never return, and a client would wait on
+        // this very daemon
+        if (remove_switch(arguments, name).size() != arguments.size())
+        {
+            throw err::UsageError(algo::format(
+                "Jobs can't use the --%s switch", name));
+        }
+    }
+
+    // undo whatever global state the previous job left behind
+    io::set_current_working_directory(job.strings.at("cwd"));
+    VirtualFileSystem::enable();
+    VirtualFileSystem::clear();
+    dec::ArchiveMetaCache::disable();
+    // game directories may have changed since; assets and plugins stay
+    AssetCache::clear_transient();
+
+    Logger job_logger(logger);
+    std::stringstream output;
+    try
+    {
+        const CliFacade cli_facade(
+            job_logger,
+            arguments,
+            output,
+            task_scheduler,
+            get_decoder_pool(job.strings.at("cwd"), arguments));
+        return make_response(cli_facade.run(), output.str(), "");
+    }
+    catch (const std::exception &e)
+    {
+        job_logger.err("Error: %s\n", e.what());
+        return make_response(1, output.str(), e.what());
+    }
+}
+
+DaemonServer::DaemonServer(Logger &logger, const io::path &socket_path)
+    : p(new Priv(logger, socket_path))
+{
+}
+
+DaemonServer::~DaemonServer()
+{
+}
+
+int DaemonServer::run() const
+{
+    #if _WIN32
+        throw err::NotSupportedError(
+            "Daemon mode is not supported on this platform");
+    #else
+        Socket server_socket;
+        server_socket.bind(p->socket_path);
+        p->logger.info("Listening on %s\n", p->socket_path.c_str());
+
+        auto should_stop = false;
+        while (!should_stop)
+        {
+            const auto client_socket = server_socket.accept();
+            std::string response;
+            try
+            {
+                response = p->serve(client_socket->read_line(), should_stop);
+            }
+            catch (const std::exception &e)
+            {
+                p->logger.err("Error: %s\n", e.what());
+                response = make_response(1, "", e.what());
+            }
+            try
+            {
+                client_socket->write(response);
+            }
+            catch (const std::exception &e)
+            {
+                p->logger.warn("Warning: %s\n", e.what());
+            }
+        }
+
+        ::unlink(p->socket_path.c_str());
+        return 0;
+    #endif
+}
+
+struct DaemonClient::Priv final
+{
+    Priv(const Logger &logger, const io::path &socket_path);
+
+    const Logger &logger;
+    const io::path socket_path;
+};
+
+DaemonClient::Priv::Priv(const Logger &logger, const io::path &socket_path)
+    : logger(logger), socket_path(socket_path)
+{
+}
+
+DaemonClient::DaemonClient(const Logger &logger, const io::path &socket_path)
+    : p(new Priv(logger, socket_path))
+{
+}
+
+DaemonClient::~DaemonClient()
+{
+}
+
+int DaemonClient::run(
+    const std::vector<std::string> &arguments, std::ostream &output) const
+{
+    #if _WIN32
+        throw err::NotSupportedError(
+            "Daemon mode is not supported on this platform");
+    #else
+        std::string request = "{\"cwd\":\"";
+        request += json::escape(io::current_working_directory().str());
+        request += "\",\"args\":[";
+        for (const auto i : algo::range(arguments.size()))
+        {
+            if (i)
+                request += ",";
+            request += "\"" + json::escape(arguments[i]) + "\"";
+        }
+        request += "]}\n";
+
+        Socket socket;
+        socket.connect(p->socket_path);
+        socket.write(request);
+        const auto response = json::parse_flat_object(socket.read_line());
+
+        const auto output_it = response.strings.find("output");
+        if (output_it != response.strings.end())
+            output << output_it->second;
+        const auto error_it = response.strings.find("error");
+        if (error_it != response.strings.end() && !error_it->second.empty())
+            p->logger.err("Error: %s\n", error_it->second.c_str());
+        const auto exit_code_it = response.numbers.find("exit_code");
+        if (exit_code_it == response.numbers.end())
+            throw err::CorruptDataError("Daemon response has no exit code");
+        return exit_code_it->second;
+    #endif
+}
@@ -0,0 +1,73 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "io/path.h"
+#include "logger.h"
+
+namespace au {
+namespace flow {
+
+    // Serves extraction and listing jobs over a Unix domain socket, so that
+    // process startup and decoder registration are paid only once.
+    //
+    // Each connection carries a single request line such as
+    // {"cwd": "/abs/dir", "args": ["file.xp3", "--list"]}
+    // or {"command": "shutdown"}, answered by a single line such as
+    // {"exit_code": 0, "output": "...", "error": ""}. Jobs run one at a
+    // time; each one still uses all worker threads.
+    class DaemonServer final
+    {
+    public:
+        DaemonServer(Logger &logger, const io::path &socket_path);
+        ~DaemonServer();
+
+        int run() const;
+
+    private:
+        struct Priv;
+        std::unique_ptr<Priv> p;
+    };
+
+    // Returns the arguments without given switch, whether its value is
+    // attached to it ("--client=x") or follows it ("--client x").
+    std::vector<std::string> remove_switch(
+        const std::vector<std::string> &arguments, const std::string &name);
+
+    // Forwards a job along with the current working directory to
+    // a DaemonServer and relays its output and exit code.
+    class DaemonClient final
+    {
+    public:
+        DaemonClient(const Logger &logger, const io::path &socket_path);
+        ~DaemonClient();
+
+        int run(
+            const std::vector<std::string> &arguments,
+            std::ostream &output) const;
+
+    private:
+        struct Priv;
+        std::unique_ptr<Priv> p;
+    };
+
+} }
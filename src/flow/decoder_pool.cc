@@ -0,0 +1,111 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#include "flow/decoder_pool.h"
+#include <map>
+#include <mutex>
+#include "arg_parser.h"
+
+using namespace au;
+using namespace au::flow;
+
+struct DecoderPool::Priv final
+{
+    Priv(
+        const dec::Registry &registry,
+        const std::vector<std::string> &arguments);
+
+    std::shared_ptr<dec::IDecoder> create_decoder(const std::string &name);
+
+    const dec::Registry &registry;
+    const std::vector<std::string> arguments;
+
+    std::mutex mutex;
+    std::map<std::string, std::shared_ptr<dec::IDecoder>> recognizers;
+    std::map<std::string, std::shared_ptr<dec::IDecoder>> decoders;
+    std::map<const dec::IDecoder*, std::set<std::string>> linked_decoder_names;
+};
+
+DecoderPool::Priv::Priv(
+    const dec::Registry &registry,
+    const std::vector<std::string> &arguments) :
+        registry(registry),
+        arguments(arguments)
+{
+}
+
+std::shared_ptr<dec::IDecoder> DecoderPool::Priv::create_decoder(
+    const std::string &name)
+{
+    auto decoder = registry.create_decoder(name);
+    ArgParser decoder_arg_parser;
+    const auto decorators = decoder->get_arg_parser_decorators();
+    for (const auto &decorator : decorators)
+        decorator.register_cli_options(decoder_arg_parser);
+    decoder_arg_parser.parse(arguments);
+    for (const auto &decorator : decorators)
+        decorator.parse_cli_options(decoder_arg_parser);
+    return decoder;
+}
+
+DecoderPool::DecoderPool(
+    const dec::Registry &registry,
+    const std::vector<std::string> &arguments)
+    : p(new Priv(registry, arguments))
+{
+}
+
+DecoderPool::~DecoderPool()
+{
+}
+
+std::shared_ptr<dec::IDecoder> DecoderPool::get_recognizer(
+    const std::string &name)
+{
+    std::unique_lock<std::mutex> lock(p->mutex);
+    const auto it = p->recognizers.find(name);
+    if (it != p->recognizers.end())
+        return it->second;
+    auto decoder = p->registry.create_decoder(name);
+    p->recognizers[name] = decoder;
+    return decoder;
+}
+
+std::shared_ptr<dec::IDecoder> DecoderPool::get_decoder(
+    const std::string &name)
+{
+    std::unique_lock<std::mutex> lock(p->mutex);
+    const auto it = p->decoders.find(name);
+    if (it != p->decoders.end())
+        return it->second;
+    // configuration errors aren't cached and resurface on every use
+    auto decoder = p->create_decoder(name);
+    p->decoders[name] = decoder;
+    return decoder;
+}
+
+std::set<std::string> DecoderPool::get_linked_decoder_names(
+    const dec::IDecoder &decoder)
+{
+    std::unique_lock<std::mutex> lock(p->mutex);
+    const auto it = p->linked_decoder_names.find(&decoder);
+    if (it != p->linked_decoder_names.end())
+        return it->second;
+    const auto names = p->registry.get_linked_decoder_names(decoder);
+    p->linked_decoder_names[&decoder] = names;
+    return names;
+}
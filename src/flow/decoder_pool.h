@@ -0,0 +1,56 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+#include "dec/idecoder.h"
+#include "dec/registry.h"
+
+namespace au {
+namespace flow {
+
+    // Hands out decoder instances configured from the command line. Each
+    // decoder is created and has its options parsed once per run; decoders
+    // are stateless after configuration, so the instances are shared across
+    // tasks.
+    class DecoderPool final
+    {
+    public:
+        DecoderPool(
+            const dec::Registry &registry,
+            const std::vector<std::string> &arguments);
+        ~DecoderPool();
+
+        // Unconfigured instances, good only for recognition, since parsing
+        // options of unrelated decoders might fail.
+        std::shared_ptr<dec::IDecoder> get_recognizer(const std::string &name);
+
+        std::shared_ptr<dec::IDecoder> get_decoder(const std::string &name);
+
+        std::set<std::string> get_linked_decoder_names(
+            const dec::IDecoder &decoder);
+
+    private:
+        struct Priv;
+        std::unique_ptr<Priv> p;
+    };
+
+} }
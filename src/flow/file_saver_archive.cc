@@ -0,0 +1,401 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#include "flow/file_saver_archive.h"
+#include <condition_variable>
+#include <cstring>
+#include <exception>
+#include <map>
+#include <mutex>
+#include <set>
+#include "algo/crypt/crc32.h"
+#include "algo/crypt/sha1.h"
+#include "algo/format.h"
+#include "err.h"
+#include "io/memory_byte_stream.h"
+
+using namespace au;
+using namespace au::flow;
+
+static const size_t tar_block_size = 512;
+static const auto tar_long_name_marker = "././@LongLink";
+
+static const u32 zip_local_header_magic = 0x04034B50;
+static const u32 zip_central_header_magic = 0x02014B50;
+static const u32 zip_end_magic = 0x06054B50;
+static const u32 zip64_end_magic = 0x06064B50;
+static const u32 zip64_end_locator_magic = 0x07064B50;
+static const u16 zip_version = 45;
+static const u16 zip_utf8_flag = 0x0800;
+static const u16 zip_dos_date = 0x0021; // 1980-01-01, keeps output stable
+
+namespace
+{
+    struct ZipEntry final
+    {
+        std::string name;
+        u32 crc;
+        u32 size;
+        uoff_t offset;
+    };
+}
+
+static void write_tar_field(
+    bstr &header, const size_t offset, const size_t size, const std::string &s)
+{
+    if (s.size() > size)
+        throw err::IoError("Tar header field overflow: " + s);
+    std::memcpy(header.get<char>() + offset, s.c_str(), s.size());
+}
+
+static void write_tar_octal(
+    bstr &header, const size_t offset, const size_t size, const uoff_t value)
+{
+    write_tar_field(
+        header,
+        offset,
+        size - 1,
+        algo::format(
+            "%0*llo",
+            static_cast<int>(size - 1),
+            static_cast<unsigned long long>(value)));
+}
+
+static bstr make_tar_header(
+    const std::string &name,
+    const uoff_t size,
+    const char type,
+    const std::string &link_name)
+{
+    bstr header(tar_block_size);
+    write_tar_field(header, 0, 100, name);
+    write_tar_octal(header, 100, 8, 0644);
+    write_tar_octal(header, 108, 8, 0);
+    write_tar_octal(header, 116, 8, 0);
+    write_tar_octal(header, 124, 12, size);
+    write_tar_octal(header, 136, 12, 0);
+    write_tar_field(header, 148, 8, "        ");
+    header[156] = type;
+    write_tar_field(header, 157, 100, link_name);
+    write_tar_field(header, 257, 6, "ustar");
+    write_tar_field(header, 263, 2, "00");
+
+    size_t checksum = 0;
+    for (const auto c : header)
+        checksum += c;
+    write_tar_octal(header, 148, 7, checksum);
+    header[154] = '\0';
+    return header;
+}
+
+static bstr pad_tar_block(const bstr &data)
+{
+    const auto padding = (tar_block_size - data.size() % tar_block_size)
+        % tar_block_size;
+    return data + bstr(padding);
+}
+
+// GNU extension: names that don't fit in the header are stored in a pseudo
+// entry preceding it
+static bstr make_tar_long_name(const std::string &name, const char type)
+{
+    if (name.size() <= 100)
+        return ""_b;
+    const auto long_name = bstr(name) + "\x00"_b;
+    return make_tar_header(tar_long_name_marker, long_name.size(), type, "")
+        + pad_tar_block(long_name);
+}
+
+static bstr make_tar_record(const std::string &name, const bstr &data)
+{
+    return make_tar_long_name(name, 'L')
+        + make_tar_header(name.substr(0, 100), data.size(), '0', "")
+        + pad_tar_block(data);
+}
+
+static bstr make_tar_link_record(
+    const std::string &name, const std::string &target_name)
+{
+    return make_tar_long_name(target_name, 'K')
+        + make_tar_long_name(name, 'L')
+        + make_tar_header(
+            name.substr(0, 100), 0, '1', target_name.substr(0, 100));
+}
+
+static bstr make_zip_record(const ZipEntry &entry, const bstr &data)
+{
+    io::MemoryByteStream record_stream;
+    record_stream.write_le<u32>(zip_local_header_magic);
+    record_stream.write_le<u16>(zip_version);
+    record_stream.write_le<u16>(zip_utf8_flag);
+    record_stream.write_le<u16>(0); // stored
+    record_stream.write_le<u16>(0);
+    record_stream.write_le<u16>(zip_dos_date);
+    record_stream.write_le<u32>(entry.crc);
+    record_stream.write_le<u32>(entry.size);
+    record_stream.write_le<u32>(entry.size);
+    record_stream.write_le<u16>(entry.name.size());
+    record_stream.write_le<u16>(0);
+    record_stream.write(entry.name);
+    record_stream.write(data);
+    return record_stream.seek(0).read_to_eof();
+}
+
+static bstr make_zip_central_directory(
+    const std::vector<ZipEntry> &entries, const uoff_t directory_offset)
+{
+    io::MemoryByteStream directory_stream;
+    for (const auto &entry : entries)
+    {
+        const auto needs_zip64 = entry.offset >= 0xFFFFFFFF;
+        directory_stream.write_le<u32>(zip_central_header_magic);
+        directory_stream.write_le<u16>(zip_version);
+        directory_stream.write_le<u16>(zip_version);
+        directory_stream.write_le<u16>(zip_utf8_flag);
+        directory_stream.write_le<u16>(0);
+        directory_stream.write_le<u16>(0);
+        directory_stream.write_le<u16>(zip_dos_date);
+        directory_stream.write_le<u32>(entry.crc);
+        directory_stream.write_le<u32>(entry.size);
+        directory_stream.write_le<u32>(entry.size);
+        directory_stream.write_le<u16>(entry.name.size());
+        directory_stream.write_le<u16>(needs_zip64 ? 12 : 0);
+        directory_stream.write_le<u16>(0);
+        directory_stream.write_le<u16>(0);
+        directory_stream.write_le<u16>(0);
+        directory_stream.write_le<u32>(0);
+        directory_stream.write_le<u32>(needs_zip64 ? 0xFFFFFFFF : entry.offset);
+        directory_stream.write(entry.name);
+        if (needs_zip64)
+        {
+            directory_stream.write_le<u16>(1);
+            directory_stream.write_le<u16>(8);
+            directory_stream.write_le<u64>(entry.offset);
+        }
+    }
+
+    const auto directory_size = directory_stream.size();
+    const auto needs_zip64
+        = entries.size() >= 0xFFFF || directory_offset >= 0xFFFFFFFF;
+    if (needs_zip64)
+    {
+        const auto zip64_end_offset = directory_offset + directory_size;
+        directory_stream.write_le<u32>(zip64_end_magic);
+        directory_stream.write_le<u64>(44);
+        directory_stream.write_le<u16>(zip_version);
+        directory_stream.write_le<u16>(zip_version);
+        directory_stream.write_le<u32>(0);
+        directory_stream.write_le<u32>(0);
+        directory_stream.write_le<u64>(entries.size());
+        directory_stream.write_le<u64>(entries.size());
+        directory_stream.write_le<u64>(directory_size);
+        directory_stream.write_le<u64>(directory_offset);
+        directory_stream.write_le<u32>(zip64_end_locator_magic);
+        directory_stream.write_le<u32>(0);
+        directory_stream.write_le<u64>(zip64_end_offset);
+        directory_stream.write_le<u32>(1);
+    }
+
+    directory_stream.write_le<u32>(zip_end_magic);
+    directory_stream.write_le<u16>(0);
+    directory_stream.write_le<u16>(0);
+    directory_stream.write_le<u16>(needs_zip64 ? 0xFFFF : entries.size());
+    directory_stream.write_le<u16>(needs_zip64 ? 0xFFFF : entries.size());
+    directory_stream.write_le<u32>(
+        needs_zip64 ? 0xFFFFFFFF : directory_size);
+    directory_stream.write_le<u32>(
+        needs_zip64 ? 0xFFFFFFFF : directory_offset);
+    directory_stream.write_le<u16>(0);
+    return directory_stream.seek(0).read_to_eof();
+}
+
+struct FileSaverArchive::Priv final
+{
+    Priv(
+        std::ostream &output,
+        const ArchiveFormat format,
+        const bool deduplicate);
+
+    io::path make_path_unique(const io::path &path);
+    void append(const bstr &record);
+    void finish();
+
+    std::ostream &output;
+    const ArchiveFormat format;
+    const bool deduplicate;
+    uoff_t output_pos;
+    size_t saved_file_count;
+    std::set<io::path> paths;
+    std::vector<ZipEntry> zip_entries;
+    std::map<bstr, io::path> content_paths;
+
+    // records are prepared concurrently, but appended in the order in
+    // which their paths were reserved
+    std::mutex mutex;
+    std::condition_variable turn_changed;
+    size_t next_ticket;
+    size_t current_ticket;
+};
+
+FileSaverArchive::Priv::Priv(
+    std::ostream &output,
+    const ArchiveFormat format,
+    const bool deduplicate) :
+        output(output),
+        format(format),
+        deduplicate(deduplicate),
+        output_pos(0),
+        saved_file_count(0),
+        next_ticket(0),
+        current_ticket(0)
+{
+}
+
+io::path FileSaverArchive::Priv::make_path_unique(const io::path &path)
+{
+    io::path new_path = path;
+    int i = 1;
+    while (paths.find(new_path) != paths.end())
+        new_path.change_stem(path.stem() + algo::format("(%d)", i++));
+    paths.insert(new_path);
+    return new_path;
+}
+
+void FileSaverArchive::Priv::append(const bstr &record)
+{
+    output.write(record.get<char>(), record.size());
+    if (!output)
+        throw err::IoError("Error writing to output archive");
+    output_pos += record.size();
+}
+
+void FileSaverArchive::Priv::finish()
+{
+    if (format == ArchiveFormat::Tar)
+        append(bstr(tar_block_size * 2));
+    else
+        append(make_zip_central_directory(zip_entries, output_pos));
+    output.flush();
+}
+
+FileSaverArchive::FileSaverArchive(
+    std::ostream &output, const ArchiveFormat format)
+    : p(new Priv(output, format, false))
+{
+}
+
+FileSaverArchive::FileSaverArchive(
+    std::ostream &output, const ArchiveFormat format, const bool deduplicate)
+    : p(new Priv(output, format, deduplicate))
+{
+}
+
+FileSaverArchive::~FileSaverArchive()
+{
+    try
+    {
+        p->finish();
+    }
+    catch (...)
+    {
+    }
+}
+
+io::path FileSaverArchive::save(std::shared_ptr<io::File> file) const
+{
+    io::path path;
+    size_t ticket;
+    {
+        std::unique_lock<std::mutex> lock(p->mutex);
+        path = p->make_path_unique(file->path);
+        ticket = p->next_ticket++;
+    }
+
+    ZipEntry zip_entry;
+    bstr record;
+    bstr digest;
+    std::exception_ptr error;
+    try
+    {
+        file->stream.seek(0);
+        const auto data = file->stream.read_to_eof();
+        if (p->format == ArchiveFormat::Tar)
+        {
+            record = make_tar_record(path.c_str(), data);
+            if (p->deduplicate)
+                digest = algo::crypt::sha1(data);
+        }
+        else
+        {
+            if (data.size() >= 0xFFFFFFFF)
+                throw err::IoError("File too large for zip: " + path.str());
+            zip_entry.name = path.c_str();
+            zip_entry.crc = algo::crypt::crc32(data);
+            zip_entry.size = data.size();
+            record = make_zip_record(zip_entry, data);
+        }
+    }
+    catch (...)
+    {
+        error = std::current_exception();
+    }
+
+    {
+        std::unique_lock<std::mutex> lock(p->mutex);
+        p->turn_changed.wait(
+            lock, [&]() { return p->current_ticket == ticket; });
+        if (!error)
+        {
+            try
+            {
+                if (!digest.empty())
+                {
+                    const auto it = p->content_paths.find(digest);
+                    if (it == p->content_paths.end())
+                    {
+                        p->content_paths[digest] = path;
+                    }
+                    else
+                    {
+                        record = make_tar_link_record(
+                            path.c_str(), it->second.c_str());
+                    }
+                }
+                zip_entry.offset = p->output_pos;
+                p->append(record);
+                if (p->format == ArchiveFormat::Zip)
+                    p->zip_entries.push_back(zip_entry);
+                ++p->saved_file_count;
+            }
+            catch (...)
+            {
+                error = std::current_exception();
+            }
+        }
+        ++p->current_ticket;
+    }
+    p->turn_changed.notify_all();
+
+    if (error)
+        std::rethrow_exception(error);
+    return path;
+}
+
+size_t FileSaverArchive::get_saved_file_count() const
+{
+    return p->saved_file_count;
+}
@@ -0,0 +1,55 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <memory>
+#include <ostream>
+#include "flow/ifile_saver.h"
+
+namespace au {
+namespace flow {
+
+    enum class ArchiveFormat : u8
+    {
+        Tar,
+        Zip,
+    };
+
+    // Streams saved files into a single uncompressed tar or store-only zip
+    // instead of creating one filesystem file per entry. The archive is
+    // finalized on destruction. With deduplication enabled, tar entries
+    // with contents identical to an earlier entry are stored as hard links.
+    class FileSaverArchive final : public IFileSaver
+    {
+    public:
+        FileSaverArchive(std::ostream &output, const ArchiveFormat format);
+        FileSaverArchive(
+            std::ostream &output,
+            const ArchiveFormat format,
+            const bool deduplicate);
+        ~FileSaverArchive();
+
+        io::path save(std::shared_ptr<io::File> file) const override;
+        size_t get_saved_file_count() const override;
+
+    private:
+        struct Priv;
+        std::unique_ptr<Priv> p;
+    };
+
+} }
@@ -16,6 +16,7 @@
 // along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
 
 #include "flow/file_saver_callback.h"
+#include <mutex>
 
 using namespace au;
 using namespace au::flow;
@@ -26,6 +27,7 @@ struct FileSaverCallback::Priv final
 
     FileSaveCallback callback;
     size_t saved_file_count;
+    std::mutex mutex;
 };
 
 FileSaverCallback::Priv::Priv(FileSaveCallback callback)
@@ -53,6 +55,8 @@ void FileSaverCallback::set_callback(FileSaveCallback callback)
 
 io::path FileSaverCallback::save(std::shared_ptr<io::File> file) const
 {
+    // unpacker threads save concurrently; spare the callbacks from locking
+    std::unique_lock<std::mutex> lock(p->mutex);
     p->callback(file);
     ++p->saved_file_count;
     return file->path;
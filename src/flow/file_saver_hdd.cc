@@ -16,8 +16,10 @@
 // along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
 
 #include "flow/file_saver_hdd.h"
+#include <map>
 #include <mutex>
 #include <set>
+#include "algo/crypt/sha1.h"
 #include "algo/format.h"
 #include "io/file_byte_stream.h"
 #include "io/file_system.h"
@@ -31,18 +33,25 @@ struct FileSaverHdd::Priv final
 {
     Priv(
         const io::path &output_dir,
-        const bool overwrite);
+        const bool overwrite,
+        const bool deduplicate);
 
     io::path make_path_unique(const io::path &path);
 
     io::path output_dir;
     bool overwrite;
+    bool deduplicate;
     size_t saved_file_count;
     std::set<io::path> paths;
+    std::map<bstr, io::path> content_paths;
 };
 
-FileSaverHdd::Priv::Priv(const io::path &output_dir, const bool overwrite)
-    : output_dir(output_dir), overwrite(overwrite), saved_file_count(0)
+FileSaverHdd::Priv::Priv(
+    const io::path &output_dir, const bool overwrite, const bool deduplicate) :
+        output_dir(output_dir),
+        overwrite(overwrite),
+        deduplicate(deduplicate),
+        saved_file_count(0)
 {
 }
 
@@ -59,9 +68,30 @@ io::path FileSaverHdd::Priv::make_path_unique(const io::path &path)
     return new_path;
 }
 
+// Returns false if the link couldn't be created (e.g. across devices), in
+// which case the file is to be written normally.
+static bool try_hard_link(const io::path &target, const io::path &link)
+{
+    try
+    {
+        io::create_hard_link(target, link);
+        return true;
+    }
+    catch (const std::exception &)
+    {
+        return false;
+    }
+}
+
 FileSaverHdd::FileSaverHdd(
     const io::path &output_dir, const bool overwrite)
-    : p(new Priv(output_dir, overwrite))
+    : p(new Priv(output_dir, overwrite, false))
+{
+}
+
+FileSaverHdd::FileSaverHdd(
+    const io::path &output_dir, const bool overwrite, const bool deduplicate)
+    : p(new Priv(output_dir, overwrite, deduplicate))
 {
 }
 
@@ -71,12 +101,52 @@ FileSaverHdd::~FileSaverHdd()
 
 io::path FileSaverHdd::save(std::shared_ptr<io::File> file) const
 {
-    std::unique_lock<std::mutex> lock(mutex);
-    const auto full_path = p->make_path_unique(p->output_dir / file->path);
-    io::create_directories(full_path.parent());
-    io::FileByteStream output_stream(full_path, io::FileMode::Write);
     file->stream.seek(0);
-    output_stream.write(file->stream);
+    bstr content;
+    bstr digest;
+    if (p->deduplicate)
+    {
+        content = file->stream.read_to_eof();
+        digest = algo::crypt::sha1(content);
+    }
+
+    io::path full_path;
+    io::path duplicate_path;
+    bool has_duplicate = false;
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        full_path = p->make_path_unique(p->output_dir / file->path);
+        io::create_directories(full_path.parent());
+        if (p->deduplicate)
+        {
+            const auto it = p->content_paths.find(digest);
+            if (it != p->content_paths.end())
+            {
+                duplicate_path = it->second;
+                has_duplicate = true;
+            }
+        }
+    }
+
+    // The target may be a hard link made by an earlier run with --dedup;
+    // writing into it would change every other copy as well.
+    if (io::exists(full_path))
+        io::remove(full_path);
+
+    if (!has_duplicate || !try_hard_link(duplicate_path, full_path))
+    {
+        io::FileByteStream output_stream(full_path, io::FileMode::Write);
+        if (p->deduplicate)
+            output_stream.write(content);
+        else
+            output_stream.write(file->stream);
+    }
+
+    std::unique_lock<std::mutex> lock(mutex);
+    // Only complete outputs are offered for linking, so identical files
+    // saved at the same time are each written out in full.
+    if (p->deduplicate && !has_duplicate)
+        p->content_paths.emplace(digest, full_path);
     ++p->saved_file_count;
     return full_path;
 }
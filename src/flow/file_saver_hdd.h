@@ -27,6 +27,10 @@ namespace flow {
     {
     public:
         FileSaverHdd(const io::path &output_dir, const bool overwrite);
+        FileSaverHdd(
+            const io::path &output_dir,
+            const bool overwrite,
+            const bool deduplicate);
         ~FileSaverHdd();
 
         io::path save(std::shared_ptr<io::File> file) const override;
@@ -0,0 +1,184 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#include "flow/journal.h"
+#include <fstream>
+#include <mutex>
+#include <set>
+#include "algo/format.h"
+#include "algo/str.h"
+#include "err.h"
+#include "io/file_byte_stream.h"
+#include "io/file_system.h"
+
+using namespace au;
+using namespace au::flow;
+
+static const std::string input_record = "input";
+static const std::string entry_record = "entry";
+
+struct Journal::Priv final
+{
+    void write(
+        const std::string &type,
+        const std::string &input_id,
+        const std::string &value);
+
+    std::mutex mutex;
+    std::ofstream output;
+    std::set<std::string> done_inputs;
+    std::set<std::pair<std::string, std::string>> done_entries;
+};
+
+void Journal::Priv::write(
+    const std::string &type,
+    const std::string &input_id,
+    const std::string &value)
+{
+    if (!output.is_open())
+        return;
+    // flush every record so that nothing is lost if the run gets killed
+    output << type << "\t" << input_id << "\t" << value << std::endl;
+}
+
+Journal::Journal() : p(new Priv)
+{
+}
+
+Journal::Journal(const io::path &path, const bool resume) : p(new Priv)
+{
+    if (resume && io::exists(path))
+    {
+        io::FileByteStream input_stream(path, io::FileMode::Read);
+        while (input_stream.left())
+        {
+            const auto fields
+                = algo::split(input_stream.read_line().str(), '\t', false);
+            if (fields.size() < 4)
+                continue;
+            const auto input_id = algo::format(
+                "%s\t%s\t%s",
+                fields[1].c_str(),
+                fields[2].c_str(),
+                fields[3].c_str());
+            if (fields[0] == input_record)
+                p->done_inputs.insert(input_id);
+            else if (fields[0] == entry_record && fields.size() == 5)
+                p->done_entries.insert({input_id, fields[4]});
+        }
+    }
+
+    io::create_directories(path.parent());
+    p->output.open(
+        path.str(), std::ios::out | (resume ? std::ios::app : std::ios::trunc));
+    if (!p->output)
+        throw err::IoError("Could not open journal " + path.str());
+}
+
+Journal::~Journal()
+{
+}
+
+std::string Journal::identify_input(const io::path &input_path)
+{
+    return algo::format(
+        "%s\t%llu\t%lld",
+        io::absolute(input_path).c_str(),
+        static_cast<unsigned long long>(io::file_size(input_path)),
+        static_cast<long long>(io::last_write_time(input_path)));
+}
+
+bool Journal::is_enabled() const
+{
+    return p->output.is_open();
+}
+
+bool Journal::is_input_done(const std::string &input_id) const
+{
+    std::unique_lock<std::mutex> lock(p->mutex);
+    return p->done_inputs.find(input_id) != p->done_inputs.end();
+}
+
+bool Journal::is_entry_done(
+    const std::string &input_id, const io::path &entry_path) const
+{
+    std::unique_lock<std::mutex> lock(p->mutex);
+    return p->done_entries.find({input_id, entry_path.str()})
+        != p->done_entries.end();
+}
+
+void Journal::mark_input_done(
+    const std::string &input_id, const std::string &decoder_name)
+{
+    std::unique_lock<std::mutex> lock(p->mutex);
+    p->done_inputs.insert(input_id);
+    p->write(input_record, input_id, decoder_name);
+}
+
+void Journal::mark_entry_done(
+    const std::string &input_id, const io::path &entry_path)
+{
+    std::unique_lock<std::mutex> lock(p->mutex);
+    p->done_entries.insert({input_id, entry_path.str()});
+    p->write(entry_record, input_id, entry_path.str());
+}
+
+JournalProgress::JournalProgress(
+    Journal &journal,
+    const std::string &input_id,
+    const io::path &entry_path,
+    const std::shared_ptr<JournalProgress> parent) :
+        journal(journal),
+        input_id(input_id),
+        entry_path(entry_path),
+        parent(parent),
+        failed(false)
+{
+}
+
+JournalProgress::~JournalProgress()
+{
+    if (failed)
+        return;
+    try
+    {
+        if (entry_path.str().empty())
+            journal.mark_input_done(input_id, decoder_name);
+        else
+            journal.mark_entry_done(input_id, entry_path);
+    }
+    catch (...)
+    {
+    }
+}
+
+const std::string &JournalProgress::get_input_id() const
+{
+    return input_id;
+}
+
+void JournalProgress::set_decoder_name(const std::string &decoder_name)
+{
+    this->decoder_name = decoder_name;
+}
+
+void JournalProgress::fail()
+{
+    failed = true;
+    if (parent)
+        parent->fail();
+}
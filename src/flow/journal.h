@@ -0,0 +1,82 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include "io/path.h"
+
+namespace au {
+namespace flow {
+
+    // Records which inputs and archive entries were fully extracted, so
+    // that interrupted or repeated runs can skip them. Inputs are identified
+    // by their path, size and modification time. A default constructed
+    // journal records nothing.
+    class Journal final
+    {
+    public:
+        Journal();
+        Journal(const io::path &path, const bool resume);
+        ~Journal();
+
+        static std::string identify_input(const io::path &input_path);
+
+        bool is_enabled() const;
+        bool is_input_done(const std::string &input_id) const;
+        bool is_entry_done(
+            const std::string &input_id, const io::path &entry_path) const;
+
+        void mark_input_done(
+            const std::string &input_id, const std::string &decoder_name);
+        void mark_entry_done(
+            const std::string &input_id, const io::path &entry_path);
+
+    private:
+        struct Priv;
+        std::unique_ptr<Priv> p;
+    };
+
+    // Marks an input or an archive entry as done once everything derived
+    // from it was processed, i.e. when the last task holding it goes away.
+    // Failures propagate to the parent so that the input is retried.
+    class JournalProgress final
+    {
+    public:
+        JournalProgress(
+            Journal &journal,
+            const std::string &input_id,
+            const io::path &entry_path,
+            const std::shared_ptr<JournalProgress> parent);
+        ~JournalProgress();
+
+        const std::string &get_input_id() const;
+        void set_decoder_name(const std::string &decoder_name);
+        void fail();
+
+    private:
+        Journal &journal;
+        const std::string input_id;
+        const io::path entry_path;
+        const std::shared_ptr<JournalProgress> parent;
+        std::string decoder_name;
+        std::atomic<bool> failed;
+    };
+
+} }
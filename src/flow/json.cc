@@ -0,0 +1,228 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#include "flow/json.h"
+#include "algo/format.h"
+#include "err.h"
+#include "types.h"
+
+using namespace au;
+using namespace au::flow;
+
+namespace
+{
+    class Parser final
+    {
+    public:
+        Parser(const std::string &input);
+
+        json::FlatObject parse_object();
+
+    private:
+        void skip_whitespace();
+        char peek();
+        void expect(const char c);
+        std::string parse_string();
+        long long parse_number();
+        std::vector<std::string> parse_array();
+
+        const std::string &input;
+        size_t pos;
+    };
+}
+
+static void append_utf8(std::string &output, const u32 code_point)
+{
+    if (code_point < 0x80)
+    {
+        output += static_cast<char>(code_point);
+    }
+    else if (code_point < 0x800)
+    {
+        output += static_cast<char>(0xC0 | (code_point >> 6));
+        output += static_cast<char>(0x80 | (code_point & 0x3F));
+    }
+    else
+    {
+        output += static_cast<char>(0xE0 | (code_point >> 12));
+        output += static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+        output += static_cast<char>(0x80 | (code_point & 0x3F));
+    }
+}
+
+Parser::Parser(const std::string &input) : input(input), pos(0)
+{
+}
+
+void Parser::skip_whitespace()
+{
+    while (pos < input.size()
+        && (input[pos] == ' '
+            || input[pos] == '\t'
+            || input[pos] == '\r'
+            || input[pos] == '\n'))
+    {
+        pos++;
+    }
+}
+
+char Parser::peek()
+{
+    skip_whitespace();
+    if (pos >= input.size())
+        throw err::CorruptDataError("Unexpected end of JSON");
+    return input[pos];
+}
+
+void Parser::expect(const char c)
+{
+    if (peek() != c)
+    {
+        throw err::CorruptDataError(
+            algo::format(
+                "Expected '%c' at position %d in JSON",
+                c,
+                static_cast<int>(pos)));
+    }
+    pos++;
+}
+
+std::string Parser::parse_string()
+{
+    expect('"');
+    std::string output;
+    while (true)
+    {
+        if (pos >= input.size())
+            throw err::CorruptDataError("Unterminated JSON string");
+        const auto c = input[pos++];
+        if (c == '"')
+            break;
+        if (c != '\\')
+        {
+            output += c;
+            continue;
+        }
+        if (pos >= input.size())
+            throw err::CorruptDataError("Unterminated JSON string");
+        const auto escaped = input[pos++];
+        if (escaped == 'n')
+            output += '\n';
+        else if (escaped == 'r')
+            output += '\r';
+        else if (escaped == 't')
+            output += '\t';
+        else if (escaped == 'b')
+            output += '\b';
+        else if (escaped == 'f')
+            output += '\f';
+        else if (escaped == 'u')
+        {
+            if (pos + 4 > input.size())
+                throw err::CorruptDataError("Bad JSON unicode escape");
+            append_utf8(
+                output, std::stoul(input.substr(pos, 4), nullptr, 16));
+            pos += 4;
+        }
+        else
+            output += escaped;
+    }
+    return output;
+}
+
+long long Parser::parse_number()
+{
+    skip_whitespace();
+    const auto start = pos;
+    if (pos < input.size() && input[pos] == '-')
+        pos++;
+    while (pos < input.size() && input[pos] >= '0' && input[pos] <= '9')
+        pos++;
+    if (pos == start)
+        throw err::CorruptDataError("Unsupported JSON value");
+    return std::stoll(input.substr(start, pos - start));
+}
+
+std::vector<std::string> Parser::parse_array()
+{
+    std::vector<std::string> output;
+    expect('[');
+    if (peek() == ']')
+    {
+        pos++;
+        return output;
+    }
+    while (true)
+    {
+        output.push_back(parse_string());
+        if (peek() == ']')
+            break;
+        expect(',');
+    }
+    pos++;
+    return output;
+}
+
+json::FlatObject Parser::parse_object()
+{
+    json::FlatObject output;
+    expect('{');
+    if (peek() == '}')
+        return output;
+    while (true)
+    {
+        const auto key = parse_string();
+        expect(':');
+        const auto c = peek();
+        if (c == '"')
+            output.strings[key] = parse_string();
+        else if (c == '[')
+            output.arrays[key] = parse_array();
+        else
+            output.numbers[key] = parse_number();
+        if (peek() == '}')
+            break;
+        expect(',');
+    }
+    return output;
+}
+
+std::string json::escape(const std::string &input)
+{
+    std::string output;
+    for (const auto c : input)
+    {
+        if (c == '"' || c == '\\')
+            output += std::string("\\") + c;
+        else if (c == '\n')
+            output += "\\n";
+        else if (c == '\r')
+            output += "\\r";
+        else if (c == '\t')
+            output += "\\t";
+        else if (static_cast<u8>(c) < 0x20)
+            output += algo::format("\\u%04x", c);
+        else
+            output += c;
+    }
+    return output;
+}
+
+json::FlatObject json::parse_flat_object(const std::string &input)
+{
+    return Parser(input).parse_object();
+}
@@ -0,0 +1,41 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace au {
+namespace flow {
+namespace json {
+
+    std::string escape(const std::string &input);
+
+    // Just enough JSON for line-delimited flat objects whose values are
+    // strings, integers or arrays of strings.
+    struct FlatObject final
+    {
+        std::map<std::string, std::string> strings;
+        std::map<std::string, long long> numbers;
+        std::map<std::string, std::vector<std::string>> arrays;
+    };
+
+    FlatObject parse_flat_object(const std::string &input);
+
+} } }
@@ -43,6 +43,13 @@ void ParallelDecoderAdapter::visit(const dec::BaseArchiveDecoder &decoder)
     parent_task->logger.info(
         "archive contains %d files.\n", meta->entries.size());
 
+    const auto &path_filter
+        = parent_task->task_context.unpacker_context.path_filter;
+    const auto &journal = parent_task->task_context.unpacker_context.journal;
+    std::string journal_input_id;
+    if (parent_task->journal_progress && !parent_task->parent_task)
+        journal_input_id = parent_task->journal_progress->get_input_id();
+
     const auto vfs_bridge = std::make_shared<VirtualFileSystemBridge>(
         parent_task->logger,
         decoder,
@@ -52,6 +59,13 @@ void ParallelDecoderAdapter::visit(const dec::BaseArchiveDecoder &decoder)
 
     for (const auto &entry : meta->entries)
     {
+        if (!path_filter.accepts(entry->path))
+            continue;
+        if (!journal_input_id.empty()
+            && journal.is_entry_done(journal_input_id, entry->path))
+        {
+            continue;
+        }
         parent_task->save_file(
             input_file,
             [meta, &entry, &decoder, vfs_bridge]
@@ -78,6 +92,14 @@ void ParallelDecoderAdapter::visit(const dec::BaseFileDecoder &decoder)
 
 void ParallelDecoderAdapter::visit(const dec::BaseImageDecoder &decoder)
 {
+    if (parent_task->source_type == TaskSourceType::NestedDecoding
+        && decoder.can_pass_through())
+    {
+        parent_task->pass_through_file(
+            input_file, decoder, decoder.canonical_extension());
+        return;
+    }
+
     parent_task->save_file(
         input_file,
         [&decoder](io::File &input_file_copy, const Logger &logger)
@@ -91,6 +113,14 @@ void ParallelDecoderAdapter::visit(const dec::BaseImageDecoder &decoder)
 
 void ParallelDecoderAdapter::visit(const dec::BaseAudioDecoder &decoder)
 {
+    if (parent_task->source_type == TaskSourceType::NestedDecoding
+        && decoder.can_pass_through())
+    {
+        parent_task->pass_through_file(
+            input_file, decoder, decoder.canonical_extension());
+        return;
+    }
+
     parent_task->save_file(
         input_file,
         [&decoder](io::File &input_file_copy, const Logger &logger)
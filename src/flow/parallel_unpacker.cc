@@ -18,7 +18,6 @@
 #include "flow/parallel_unpacker.h"
 #include <chrono>
 #include <set>
-#include <stack>
 #include "algo/format.h"
 #include "dec/idecoder.h"
 #include "err.h"
@@ -41,9 +40,10 @@ namespace
             const io::path &base_name,
             const std::shared_ptr<const BaseParallelUnpackingTask> parent_task,
             const std::set<std::string> &decoders_to_check,
+            const std::shared_ptr<JournalProgress> journal_progress,
             const InputFileFactory file_factory);
 
-        bool work() const override;
+        bool work_impl() const override;
 
         const InputFileFactory file_factory;
     };
@@ -56,17 +56,20 @@ namespace
             const io::path &base_name,
             const std::shared_ptr<const BaseParallelUnpackingTask> parent_task,
             const std::set<std::string> &decoders_to_check,
+            const std::shared_ptr<JournalProgress> journal_progress,
             const std::shared_ptr<io::File> input_file,
             const DecoderFileFactory file_factory,
             const std::shared_ptr<const dec::IDecoder> origin_decoder,
-            const std::string &target_name);
+            const std::string &target_name,
+            const bool allow_nested_decoding);
 
-        bool work() const override;
+        bool work_impl() const override;
 
         const std::shared_ptr<io::File> input_file;
         const DecoderFileFactory file_factory;
         const std::shared_ptr<const dec::IDecoder> origin_decoder;
         const std::string target_name;
+        const bool allow_nested_decoding;
     };
 }
 
@@ -90,31 +93,7 @@ static bool save(
     }
 }
 
-static std::set<std::string> collect_linked_decoders(
-    const dec::IDecoder &base_decoder, const dec::Registry &registry)
-{
-    std::set<std::string> known_formats;
-    std::vector<std::shared_ptr<dec::IDecoder>> linked_decoders;
-    std::stack<const dec::IDecoder*> decoders_to_inspect;
-    decoders_to_inspect.push(&base_decoder);
-    while (!decoders_to_inspect.empty())
-    {
-        const auto decoder_to_inspect = decoders_to_inspect.top();
-        decoders_to_inspect.pop();
-        for (const auto &format : decoder_to_inspect->get_linked_formats())
-        {
-            if (known_formats.find(format) != known_formats.end())
-                continue;
-            known_formats.insert(format);
-            auto linked_decoder = registry.create_decoder(format);
-            decoders_to_inspect.push(linked_decoder.get());
-            linked_decoders.push_back(std::move(linked_decoder));
-        }
-    }
-    return std::set<std::string>(known_formats.begin(), known_formats.end());
-}
-
-static std::shared_ptr<dec::IDecoder> guess_decoder(
+static std::string guess_decoder(
     const BaseParallelUnpackingTask &task,
     const std::set<std::string> &decoders_to_check,
     io::File &file,
@@ -127,7 +106,7 @@ static std::shared_ptr<dec::IDecoder> guess_decoder(
     for (const auto &name : decoders_to_check)
     {
         const auto current_decoder
-            = task.task_context.unpacker_context.registry.create_decoder(name);
+            = task.task_context.decoder_pool.get_recognizer(name);
         if (current_decoder->is_recognized(file))
             matching_decoders[name] = std::move(current_decoder);
     }
@@ -136,7 +115,7 @@ static std::shared_ptr<dec::IDecoder> guess_decoder(
     {
         task.logger.success(
             "recognized as %s.\n", matching_decoders.begin()->first.c_str());
-        return matching_decoders.begin()->second;
+        return matching_decoders.begin()->first;
     }
 
     if (matching_decoders.empty())
@@ -149,7 +128,7 @@ static std::shared_ptr<dec::IDecoder> guess_decoder(
         {
             task.logger.err("not recognized by any decoder.\n");
         }
-        return nullptr;
+        return "";
     }
 
     if (source_type == TaskSourceType::NestedDecoding)
@@ -163,19 +142,23 @@ static std::shared_ptr<dec::IDecoder> guess_decoder(
             task.logger.warn("- " + it.first + "\n");
         task.logger.warn("Please provide --dec and proceed manually.\n");
     }
-    return nullptr;
+    return "";
 }
 
 ParallelUnpackerContext::ParallelUnpackerContext(
     const Logger &logger,
     const IFileSaver &file_saver,
     const dec::Registry &registry,
+    const PathFilter &path_filter,
+    Journal &journal,
     const bool enable_nested_decoding,
     const std::vector<std::string> &arguments,
     const std::set<std::string> &decoders_to_check) :
         logger(logger),
         file_saver(file_saver),
         registry(registry),
+        path_filter(path_filter),
+        journal(journal),
         enable_nested_decoding(enable_nested_decoding),
         arguments(arguments),
         decoders_to_check(decoders_to_check)
@@ -185,10 +168,12 @@ ParallelUnpackerContext::ParallelUnpackerContext(
 ParallelTaskContext::ParallelTaskContext(
     ParallelUnpacker &unpacker,
     const ParallelUnpackerContext &unpacker_context,
-    TaskScheduler &task_scheduler) :
+    TaskScheduler &task_scheduler,
+    DecoderPool &decoder_pool) :
         unpacker(unpacker),
         unpacker_context(unpacker_context),
-        task_scheduler(task_scheduler)
+        task_scheduler(task_scheduler),
+        decoder_pool(decoder_pool)
 {
 }
 
@@ -197,13 +182,15 @@ BaseParallelUnpackingTask::BaseParallelUnpackingTask(
     const TaskSourceType source_type,
     const io::path &base_name,
     const std::shared_ptr<const BaseParallelUnpackingTask> parent_task,
-    const std::set<std::string> &decoders_to_check) :
+    const std::set<std::string> &decoders_to_check,
+    const std::shared_ptr<JournalProgress> journal_progress) :
         logger(task_context.unpacker_context.logger),
         task_context(task_context),
         source_type(source_type),
         base_name(base_name),
         parent_task(parent_task),
-        decoders_to_check(decoders_to_check)
+        decoders_to_check(decoders_to_check),
+        journal_progress(journal_progress)
 {
     mutex.lock();
     const auto task_id = task_count++;
@@ -212,6 +199,14 @@ BaseParallelUnpackingTask::BaseParallelUnpackingTask(
         algo::format("[task %d] %s: ", task_id, base_name.c_str()));
 }
 
+bool BaseParallelUnpackingTask::work() const
+{
+    const auto result = work_impl();
+    if (!result && journal_progress)
+        journal_progress->fail();
+    return result;
+}
+
 size_t BaseParallelUnpackingTask::get_depth() const
 {
     auto depth = 0;
@@ -230,6 +225,17 @@ void BaseParallelUnpackingTask::save_file(
     const dec::BaseDecoder &origin_decoder,
     const std::string &target_name) const
 {
+    // entries of the input archives are journaled individually
+    auto output_journal_progress = journal_progress;
+    if (journal_progress && !parent_task && !target_name.empty())
+    {
+        output_journal_progress = std::make_shared<JournalProgress>(
+            task_context.unpacker_context.journal,
+            journal_progress->get_input_id(),
+            target_name,
+            journal_progress);
+    }
+
     task_context.task_scheduler.push_front(
         std::make_shared<ProcessOutputFileTask>(
             task_context,
@@ -238,10 +244,37 @@ void BaseParallelUnpackingTask::save_file(
             shared_from_this(),
             source_type == TaskSourceType::InitialUserInput
                 ? std::set<std::string>() : decoders_to_check,
+            output_journal_progress,
             input_file,
             file_factory,
             origin_decoder.shared_from_this(),
-            target_name));
+            target_name,
+            true));
+}
+
+void BaseParallelUnpackingTask::pass_through_file(
+    const std::shared_ptr<io::File> input_file,
+    const dec::BaseDecoder &origin_decoder,
+    const std::string &extension) const
+{
+    task_context.task_scheduler.push_front(
+        std::make_shared<ProcessOutputFileTask>(
+            task_context,
+            source_type,
+            base_name,
+            shared_from_this(),
+            std::set<std::string>(),
+            journal_progress,
+            input_file,
+            [extension](io::File &input_file_copy, const Logger &logger)
+            {
+                auto output_file = std::make_unique<io::File>(input_file_copy);
+                output_file->path.change_extension(extension);
+                return output_file;
+            },
+            origin_decoder.shared_from_this(),
+            "",
+            false));
 }
 
 DecodeInputFileTask::DecodeInputFileTask(
@@ -250,18 +283,20 @@ DecodeInputFileTask::DecodeInputFileTask(
     const io::path &base_name,
     const std::shared_ptr<const BaseParallelUnpackingTask> parent_task,
     const std::set<std::string> &decoders_to_check,
+    const std::shared_ptr<JournalProgress> journal_progress,
     const InputFileFactory file_factory) :
         BaseParallelUnpackingTask(
             task_context,
             source_type,
             base_name,
             parent_task,
-            decoders_to_check),
+            decoders_to_check,
+            journal_progress),
         file_factory(file_factory)
 {
 }
 
-bool DecodeInputFileTask::work() const
+bool DecodeInputFileTask::work_impl() const
 {
     std::shared_ptr<io::File> input_file;
     try
@@ -283,24 +318,21 @@ bool DecodeInputFileTask::work() const
     {
         logger.info("initial recognition...\n");
 
-        const auto decoder = guess_decoder(
+        const auto decoder_name = guess_decoder(
             *this, decoders_to_check, *input_file, source_type);
 
-        if (!decoder)
+        if (decoder_name.empty())
         {
             return source_type == TaskSourceType::NestedDecoding
                 ? save(*this, input_file)
                 : false;
         }
 
-        ArgParser decoder_arg_parser;
-        const auto decorators = decoder->get_arg_parser_decorators();
-        for (const auto &decorator : decorators)
-            decorator.register_cli_options(decoder_arg_parser);
-        decoder_arg_parser.parse(task_context.unpacker_context.arguments);
-        for (const auto &decorator : decorators)
-            decorator.parse_cli_options(decoder_arg_parser);
+        if (journal_progress && !parent_task)
+            journal_progress->set_decoder_name(decoder_name);
 
+        const auto decoder
+            = task_context.decoder_pool.get_decoder(decoder_name);
         ParallelDecoderAdapter adapter(shared_from_this(), input_file);
         decoder->accept(adapter);
         return true;
@@ -320,24 +352,28 @@ ProcessOutputFileTask::ProcessOutputFileTask(
     const io::path &base_name,
     const std::shared_ptr<const BaseParallelUnpackingTask> parent_task,
     const std::set<std::string> &decoders_to_check,
+    const std::shared_ptr<JournalProgress> journal_progress,
     const std::shared_ptr<io::File> input_file,
     const DecoderFileFactory file_factory,
     const std::shared_ptr<const dec::IDecoder> origin_decoder,
-    const std::string &target_name) :
+    const std::string &target_name,
+    const bool allow_nested_decoding) :
         BaseParallelUnpackingTask(
             task_context,
             source_type,
             base_name,
             parent_task,
-            decoders_to_check),
+            decoders_to_check,
+            journal_progress),
         input_file(input_file),
         file_factory(file_factory),
         origin_decoder(origin_decoder),
-        target_name(target_name)
+        target_name(target_name),
+        allow_nested_decoding(allow_nested_decoding)
 {
 }
 
-bool ProcessOutputFileTask::work() const
+bool ProcessOutputFileTask::work_impl() const
 {
     logger.info(
         target_name.empty()
@@ -391,11 +427,14 @@ bool ProcessOutputFileTask::work() const
     output_file->path = algo::apply_naming_strategy(
         naming_strategy, base_name, output_file->path);
 
-    if (!task_context.unpacker_context.enable_nested_decoding)
+    if (!task_context.unpacker_context.enable_nested_decoding
+        || !allow_nested_decoding)
+    {
         return save(*this, output_file);
+    }
 
-    auto linked_decoders = collect_linked_decoders(
-        *origin_decoder, task_context.unpacker_context.registry);
+    auto linked_decoders
+        = task_context.decoder_pool.get_linked_decoder_names(*origin_decoder);
     linked_decoders.insert(
         decoders_to_check.begin(), decoders_to_check.end());
 
@@ -415,6 +454,7 @@ bool ProcessOutputFileTask::work() const
             output_file->path,
             shared_from_this(),
             linked_decoders,
+            journal_progress,
             [=]() { return output_file; }));
 
     return true;
@@ -426,8 +466,18 @@ struct ParallelUnpacker::Priv final
         ParallelUnpacker &unpacker,
         const ParallelUnpackerContext &unpacker_context);
 
+    Priv(
+        ParallelUnpacker &unpacker,
+        const ParallelUnpackerContext &unpacker_context,
+        TaskScheduler &task_scheduler,
+        DecoderPool &decoder_pool);
+
+    ~Priv();
+
     const ParallelUnpackerContext &unpacker_context;
-    TaskScheduler task_scheduler;
+    std::unique_ptr<TaskScheduler> own_task_scheduler;
+    std::unique_ptr<DecoderPool> own_decoder_pool;
+    TaskScheduler &task_scheduler;
     ParallelTaskContext task_context;
 };
 
@@ -435,8 +485,31 @@ ParallelUnpacker::Priv::Priv(
     ParallelUnpacker &unpacker,
     const ParallelUnpackerContext &unpacker_context) :
         unpacker_context(unpacker_context),
-        task_context(unpacker, unpacker_context, task_scheduler)
+        own_task_scheduler(new TaskScheduler()),
+        own_decoder_pool(new DecoderPool(
+            unpacker_context.registry, unpacker_context.arguments)),
+        task_scheduler(*own_task_scheduler),
+        task_context(
+            unpacker, unpacker_context, task_scheduler, *own_decoder_pool)
+{
+}
+
+ParallelUnpacker::Priv::Priv(
+    ParallelUnpacker &unpacker,
+    const ParallelUnpackerContext &unpacker_context,
+    TaskScheduler &task_scheduler,
+    DecoderPool &decoder_pool) :
+        unpacker_context(unpacker_context),
+        task_scheduler(task_scheduler),
+        task_context(unpacker, unpacker_context, task_scheduler, decoder_pool)
+{
+}
+
+ParallelUnpacker::Priv::~Priv()
 {
+    // tasks of a run that never started refer to this unpacker, and a
+    // shared scheduler would otherwise run them along with the next one
+    task_scheduler.clear();
 }
 
 ParallelUnpacker::ParallelUnpacker(
@@ -445,6 +518,14 @@ ParallelUnpacker::ParallelUnpacker(
 {
 }
 
+ParallelUnpacker::ParallelUnpacker(
+    const ParallelUnpackerContext &unpacker_context,
+    TaskScheduler &task_scheduler,
+    DecoderPool &decoder_pool)
+        : p(new Priv(*this, unpacker_context, task_scheduler, decoder_pool))
+{
+}
+
 ParallelUnpacker::~ParallelUnpacker()
 {
 }
@@ -452,6 +533,29 @@ ParallelUnpacker::~ParallelUnpacker()
 void ParallelUnpacker::add_input_file(
     const io::path &base_name, const InputFileFactory file_factory)
 {
+    add_input_file(base_name, file_factory, "");
+}
+
+void ParallelUnpacker::add_input_file(
+    const io::path &base_name,
+    const InputFileFactory file_factory,
+    const std::string &journal_input_id)
+{
+    auto &journal = p->unpacker_context.journal;
+    std::shared_ptr<JournalProgress> journal_progress;
+    if (journal.is_enabled() && !journal_input_id.empty())
+    {
+        if (journal.is_input_done(journal_input_id))
+        {
+            p->unpacker_context.logger.info(
+                "%s: skipped (unchanged since last run).\n",
+                base_name.c_str());
+            return;
+        }
+        journal_progress = std::make_shared<JournalProgress>(
+            journal, journal_input_id, "", nullptr);
+    }
+
     p->task_scheduler.push_back(
         std::make_shared<DecodeInputFileTask>(
             p->task_context,
@@ -459,6 +563,7 @@ void ParallelUnpacker::add_input_file(
             base_name,
             nullptr,
             p->unpacker_context.decoders_to_check,
+            journal_progress,
             file_factory));
 }
 
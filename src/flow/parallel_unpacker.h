@@ -22,7 +22,10 @@
 #include <set>
 #include "dec/base_decoder.h"
 #include "dec/registry.h"
+#include "flow/decoder_pool.h"
 #include "flow/ifile_saver.h"
+#include "flow/journal.h"
+#include "flow/path_filter.h"
 #include "flow/task_scheduler.h"
 #include "logger.h"
 
@@ -47,6 +50,8 @@ namespace flow {
             const Logger &logger,
             const IFileSaver &file_saver,
             const dec::Registry &registry,
+            const PathFilter &path_filter,
+            Journal &journal,
             const bool enable_nested_decoding,
             const std::vector<std::string> &arguments,
             const std::set<std::string> &decoders_to_check);
@@ -54,6 +59,8 @@ namespace flow {
         const Logger &logger;
         const IFileSaver &file_saver;
         const dec::Registry &registry;
+        const PathFilter &path_filter;
+        Journal &journal;
         const bool enable_nested_decoding;
         const std::vector<std::string> arguments;
         const std::set<std::string> decoders_to_check;
@@ -64,11 +71,13 @@ namespace flow {
         ParallelTaskContext(
             ParallelUnpacker &unpacker,
             const ParallelUnpackerContext &unpacker_context,
-            TaskScheduler &task_scheduler);
+            TaskScheduler &task_scheduler,
+            DecoderPool &decoder_pool);
 
         ParallelUnpacker &unpacker;
         const ParallelUnpackerContext &unpacker_context;
         TaskScheduler &task_scheduler;
+        DecoderPool &decoder_pool;
     };
 
     struct BaseParallelUnpackingTask :
@@ -80,10 +89,12 @@ namespace flow {
             const TaskSourceType source_type,
             const io::path &base_name,
             const std::shared_ptr<const BaseParallelUnpackingTask> parent_task,
-            const std::set<std::string> &decoders_to_check);
+            const std::set<std::string> &decoders_to_check,
+            const std::shared_ptr<JournalProgress> journal_progress);
 
         virtual ~BaseParallelUnpackingTask() {}
 
+        bool work() const override final;
         size_t get_depth() const;
 
         void save_file(
@@ -92,21 +103,43 @@ namespace flow {
             const dec::BaseDecoder &origin_decoder,
             const std::string &custom_name = "") const;
 
+        void pass_through_file(
+            const std::shared_ptr<io::File> input_file,
+            const dec::BaseDecoder &origin_decoder,
+            const std::string &extension) const;
+
         Logger logger;
         ParallelTaskContext &task_context;
         const TaskSourceType source_type;
         const io::path base_name;
         const std::shared_ptr<const BaseParallelUnpackingTask> parent_task;
         const std::set<std::string> decoders_to_check;
+        const std::shared_ptr<JournalProgress> journal_progress;
+
+    protected:
+        virtual bool work_impl() const = 0;
     };
 
     class ParallelUnpacker final
     {
     public:
         ParallelUnpacker(const ParallelUnpackerContext &unpacker_context);
+
+        // Runs on given scheduler and decoders rather than on its own.
+        // The decoder pool must have been created with the context's
+        // registry and arguments.
+        ParallelUnpacker(
+            const ParallelUnpackerContext &unpacker_context,
+            TaskScheduler &task_scheduler,
+            DecoderPool &decoder_pool);
+
         ~ParallelUnpacker();
 
         void add_input_file(const io::path &base_name, const InputFileFactory);
+        void add_input_file(
+            const io::path &base_name,
+            const InputFileFactory,
+            const std::string &journal_input_id);
         bool run(const size_t thread_count = 0);
 
     private:
@@ -0,0 +1,145 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#include "flow/path_filter.h"
+#include <regex>
+#include <set>
+#include "err.h"
+
+using namespace au;
+using namespace au::flow;
+
+static const std::string regex_prefix = "regex:";
+
+namespace
+{
+    struct Pattern final
+    {
+        Pattern(const std::string &pattern);
+        bool matches(const io::path &path) const;
+
+        std::regex regex;
+        bool is_glob;
+        bool matches_name_only;
+    };
+}
+
+static std::string glob_to_regex(const std::string &glob)
+{
+    std::string output;
+    for (size_t i = 0; i < glob.size(); i++)
+    {
+        const auto c = glob[i];
+        if (c == '*' && i + 1 < glob.size() && glob[i + 1] == '*')
+        {
+            output += ".*";
+            i++;
+        }
+        else if (c == '*')
+            output += "[^/]*";
+        else if (c == '?')
+            output += "[^/]";
+        else if (std::string("\\^$.|+()[]{}").find(c) != std::string::npos)
+            output += std::string("\\") + c;
+        else
+            output += c;
+    }
+    return output;
+}
+
+Pattern::Pattern(const std::string &pattern)
+{
+    is_glob = pattern.compare(0, regex_prefix.size(), regex_prefix) != 0;
+    matches_name_only = is_glob && pattern.find('/') == std::string::npos;
+    try
+    {
+        regex = std::regex(
+            is_glob
+                ? glob_to_regex(io::path(pattern).c_str())
+                : pattern.substr(regex_prefix.size()),
+            std::regex_constants::ECMAScript | std::regex_constants::icase);
+    }
+    catch (const std::regex_error &)
+    {
+        throw err::UsageError("Invalid pattern: " + pattern);
+    }
+}
+
+bool Pattern::matches(const io::path &path) const
+{
+    if (!is_glob)
+        return std::regex_search(path.c_str(), regex);
+    if (matches_name_only)
+        return std::regex_match(path.name(), regex);
+    return std::regex_match(path.c_str(), regex);
+}
+
+struct PathFilter::Priv final
+{
+    std::vector<Pattern> include_patterns;
+    std::vector<Pattern> exclude_patterns;
+    std::set<io::path> included_paths;
+};
+
+PathFilter::PathFilter() : p(new Priv)
+{
+}
+
+PathFilter::~PathFilter()
+{
+}
+
+void PathFilter::add_include_pattern(const std::string &pattern)
+{
+    p->include_patterns.push_back(Pattern(pattern));
+}
+
+void PathFilter::add_exclude_pattern(const std::string &pattern)
+{
+    p->exclude_patterns.push_back(Pattern(pattern));
+}
+
+void PathFilter::add_included_path(const io::path &path)
+{
+    p->included_paths.insert(path);
+}
+
+bool PathFilter::is_empty() const
+{
+    return p->include_patterns.empty()
+        && p->exclude_patterns.empty()
+        && p->included_paths.empty();
+}
+
+bool PathFilter::accepts(const io::path &path) const
+{
+    for (const auto &pattern : p->exclude_patterns)
+        if (pattern.matches(path))
+            return false;
+
+    if (p->include_patterns.empty() && p->included_paths.empty())
+        return true;
+
+    if (p->included_paths.find(path) != p->included_paths.end())
+        return true;
+
+    for (const auto &pattern : p->include_patterns)
+        if (pattern.matches(path))
+            return true;
+
+    return false;
+}
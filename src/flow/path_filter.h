@@ -0,0 +1,48 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <memory>
+#include "io/path.h"
+
+namespace au {
+namespace flow {
+
+    // Decides which archive entries get extracted. Patterns are globs
+    // matched against the whole entry path, or against the file name alone
+    // if they contain no slashes; patterns prefixed with "regex:" are
+    // ECMAScript regular expressions searched for in the entry path.
+    class PathFilter final
+    {
+    public:
+        PathFilter();
+        ~PathFilter();
+
+        void add_include_pattern(const std::string &pattern);
+        void add_exclude_pattern(const std::string &pattern);
+        void add_included_path(const io::path &path);
+
+        bool is_empty() const;
+        bool accepts(const io::path &path) const;
+
+    private:
+        struct Priv;
+        std::unique_ptr<Priv> p;
+    };
+
+} }
@@ -16,22 +16,89 @@
 // along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
 
 #include "flow/task_scheduler.h"
-#include <chrono>
+#include <condition_variable>
 #include <deque>
 #include <thread>
 #include <vector>
-#include "algo/range.h"
 
 using namespace au;
 using namespace au::flow;
 
 struct TaskScheduler::Priv final
 {
+    Priv(TaskScheduler &scheduler);
+    ~Priv();
+
+    void work(const size_t thread_index);
+    bool is_idle() const;
+
+    TaskScheduler &scheduler;
     std::deque<std::shared_ptr<ITask>> tasks;
-    std::vector<std::unique_ptr<std::thread>> threads;
+    std::vector<std::thread> threads;
+    std::condition_variable task_added;
+    std::condition_variable task_finished;
+
+    // workers with lower indices take part in the current run
+    size_t active_thread_count;
+    size_t busy_thread_count;
+    bool stopping;
+    TaskSchedulerResult result;
 };
 
-TaskScheduler::TaskScheduler() : p(new Priv())
+TaskScheduler::Priv::Priv(TaskScheduler &scheduler) :
+    scheduler(scheduler),
+    active_thread_count(0),
+    busy_thread_count(0),
+    stopping(false)
+{
+}
+
+TaskScheduler::Priv::~Priv()
+{
+    {
+        std::unique_lock<std::mutex> lock(scheduler.mutex);
+        stopping = true;
+    }
+    task_added.notify_all();
+    for (auto &thread : threads)
+        thread.join();
+}
+
+bool TaskScheduler::Priv::is_idle() const
+{
+    return tasks.empty() && !busy_thread_count;
+}
+
+void TaskScheduler::Priv::work(const size_t thread_index)
+{
+    std::unique_lock<std::mutex> lock(scheduler.mutex);
+    while (true)
+    {
+        task_added.wait(lock, [&]()
+        {
+            return stopping
+                || (thread_index < active_thread_count && !tasks.empty());
+        });
+        if (stopping)
+            return;
+
+        const auto task = tasks.front();
+        tasks.pop_front();
+        busy_thread_count++;
+        lock.unlock();
+
+        const auto local_success = task->work();
+
+        lock.lock();
+        busy_thread_count--;
+        result.success_count += local_success;
+        result.error_count += !local_success;
+        if (is_idle())
+            task_finished.notify_all();
+    }
+}
+
+TaskScheduler::TaskScheduler() : p(new Priv(*this))
 {
 }
 
@@ -41,14 +108,26 @@ TaskScheduler::~TaskScheduler()
 
 void TaskScheduler::push_front(std::shared_ptr<ITask> task)
 {
-    std::unique_lock<std::mutex> lock(mutex);
-    p->tasks.push_front(task);
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        p->tasks.push_front(task);
+    }
+    p->task_added.notify_one();
 }
 
 void TaskScheduler::push_back(std::shared_ptr<ITask> task)
+{
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        p->tasks.push_back(task);
+    }
+    p->task_added.notify_one();
+}
+
+void TaskScheduler::clear()
 {
     std::unique_lock<std::mutex> lock(mutex);
-    p->tasks.push_back(task);
+    p->tasks.clear();
 }
 
 TaskSchedulerResult TaskScheduler::run(size_t number_of_threads)
@@ -58,50 +137,21 @@ TaskSchedulerResult TaskScheduler::run(size_t number_of_threads)
     if (!number_of_threads)
         number_of_threads = 1;
 
-    TaskSchedulerResult result;
-    result.success_count = 0;
-    result.error_count = 0;
-    bool still_running = true;
-
-    for (const auto i : algo::range(number_of_threads))
+    std::unique_lock<std::mutex> lock(mutex);
+    while (p->threads.size() < number_of_threads)
     {
-        p->threads.push_back(std::make_unique<std::thread>([&]()
+        const auto thread_index = p->threads.size();
+        p->threads.emplace_back([this, thread_index]()
         {
-            while (true)
-            {
-                std::shared_ptr<ITask> task;
-
-                {
-                    std::unique_lock<std::mutex> lock(mutex);
-                    if (p->tasks.empty())
-                    {
-                        if (still_running && number_of_threads > 1)
-                        {
-                            lock.unlock();
-                            std::this_thread::sleep_for(
-                                std::chrono::milliseconds(10));
-                            continue;
-                        }
-                        break;
-                    }
-                    task = p->tasks.front();
-                    p->tasks.pop_front();
-                }
-
-                const auto local_success = task->work();
-
-                {
-                    std::unique_lock<std::mutex> lock(mutex);
-                    result.success_count += local_success;
-                    result.error_count += !local_success;
-                    still_running = !p->tasks.empty();
-                }
-            }
-        }));
+            p->work(thread_index);
+        });
     }
 
-    for (auto &t : p->threads)
-        t->join();
-
-    return result;
+    p->result.success_count = 0;
+    p->result.error_count = 0;
+    p->active_thread_count = number_of_threads;
+    p->task_added.notify_all();
+    p->task_finished.wait(lock, [&]() { return p->is_idle(); });
+    p->active_thread_count = 0;
+    return p->result;
 }
@@ -36,6 +36,9 @@ namespace flow {
         int error_count;
     };
 
+    // Runs tasks, including the ones they push while running, on a pool of
+    // worker threads. The workers outlive run() and wait for the next
+    // call, so a long-lived scheduler doesn't pay for them again.
     class TaskScheduler final
     {
     public:
@@ -44,7 +47,10 @@ namespace flow {
         TaskSchedulerResult run(const size_t number_of_threads = 0);
         void push_front(std::shared_ptr<ITask> task);
         void push_back(std::shared_ptr<ITask> task);
-        void join();
+
+        // Drops the tasks that haven't started yet.
+        void clear();
+
         std::mutex mutex;
     private:
         struct Priv;
@@ -151,6 +151,13 @@ namespace io {
 
         virtual std::unique_ptr<BaseByteStream> clone() const = 0;
 
+        // Memory holding the whole stream, for streams that keep one, so that
+        // SpanReader can avoid copying. Invalidated by writes and resizes.
+        virtual const u8 *data() const
+        {
+            return nullptr;
+        }
+
     protected:
         virtual void read_impl(void *input, const size_t size) = 0;
         virtual void write_impl(const void *str, const size_t size) = 0;
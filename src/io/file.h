@@ -30,6 +30,7 @@ namespace io {
         File(const io::path &path, std::unique_ptr<io::BaseByteStream> stream);
         File(const io::path &path, const io::FileMode mode);
         File(const io::path &path, const bstr &data);
+        File(const io::path &path, bstr &&data);
         File();
         ~File();
 
@@ -41,11 +41,26 @@ path io::current_working_directory()
     return boost::filesystem::current_path().string();
 }
 
+void io::set_current_working_directory(const path &p)
+{
+    boost::filesystem::current_path(p.str());
+}
+
 path io::absolute(const path &p)
 {
     return boost::filesystem::absolute(p.str()).string();
 }
 
+uoff_t io::file_size(const path &p)
+{
+    return boost::filesystem::file_size(p.str());
+}
+
+std::time_t io::last_write_time(const path &p)
+{
+    return boost::filesystem::last_write_time(p.str());
+}
+
 void io::create_directories(const path &p)
 {
     const auto bp = boost::filesystem::path(p.str());
@@ -57,3 +72,8 @@ void io::remove(const path &p)
 {
     boost::filesystem::remove(p.str());
 }
+
+void io::create_hard_link(const path &target, const path &link)
+{
+    boost::filesystem::create_hard_link(target.str(), link.str());
+}
@@ -18,19 +18,25 @@
 #pragma once
 
 #include <boost/filesystem.hpp>
+#include <ctime>
 #include "io/path.h"
+#include "types.h"
 
 namespace au {
 namespace io {
 
     path current_working_directory();
+    void set_current_working_directory(const path &p);
     bool exists(const path &p);
     bool is_directory(const path &p);
     bool is_regular_file(const path &p);
     path absolute(const path &p);
+    uoff_t file_size(const path &p);
+    std::time_t last_write_time(const path &p);
 
     void create_directories(const path &p);
     void remove(const path &p);
+    void create_hard_link(const path &target, const path &link);
 
     template<typename T> class BaseDirectoryRange final
     {
@@ -31,6 +31,7 @@ namespace io {
         MemoryByteStream();
         MemoryByteStream(const char *buffer, const size_t buffer_size);
         MemoryByteStream(const bstr &buffer);
+        MemoryByteStream(bstr &&buffer);
         MemoryByteStream(BaseByteStream &other_stream, const size_t size);
         MemoryByteStream(BaseByteStream &other_stream);
         ~MemoryByteStream();
@@ -41,6 +42,7 @@ namespace io {
         BaseByteStream &reserve(const uoff_t count);
 
         std::unique_ptr<BaseByteStream> clone() const override;
+        const u8 *data() const override;
 
     protected:
         void read_impl(void *destination, const size_t size) override;
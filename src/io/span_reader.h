@@ -0,0 +1,210 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <cstring>
+#include <memory>
+#include "algo/endian.h"
+#include "err.h"
+#include "io/base_byte_stream.h"
+#include "types.h"
+
+namespace au {
+namespace io {
+
+    // Non-virtual counterpart of BaseByteStream for reading contiguous
+    // memory in inner loops. Every operation is a single bounds check
+    // followed by a copy the compiler can inline.
+    class SpanReader final
+    {
+    public:
+        SpanReader(const u8 *data, const size_t size)
+            : data_ptr(data), data_size(size), data_pos(0)
+        {
+        }
+
+        // Doesn't copy, so the data must outlive the reader...
+        SpanReader(const bstr &data) : SpanReader(data.get<u8>(), data.size())
+        {
+        }
+
+        // ...unless it's a temporary.
+        SpanReader(bstr &&data)
+            : holder(std::make_shared<const bstr>(std::move(data)))
+        {
+            data_ptr = holder->get<u8>();
+            data_size = holder->size();
+            data_pos = 0;
+        }
+
+        // Takes given number of bytes from the current position of the
+        // stream. Memory-backed streams hand out their buffer, the rest
+        // is read into a private copy.
+        SpanReader(BaseByteStream &input_stream, const size_t size)
+        {
+            data_ptr = input_stream.data();
+            if (data_ptr)
+            {
+                if (size > input_stream.left())
+                    throw err::EofError();
+                data_ptr += input_stream.pos();
+                input_stream.skip(size);
+            }
+            else
+            {
+                holder = std::make_shared<const bstr>(input_stream.read(size));
+                data_ptr = holder->get<u8>();
+            }
+            data_size = size;
+            data_pos = 0;
+        }
+
+        SpanReader(BaseByteStream &input_stream)
+            : SpanReader(input_stream, input_stream.left())
+        {
+        }
+
+        size_t size() const
+        {
+            return data_size;
+        }
+
+        size_t pos() const
+        {
+            return data_pos;
+        }
+
+        size_t left() const
+        {
+            return data_size - data_pos;
+        }
+
+        bool eof() const
+        {
+            return data_pos == data_size;
+        }
+
+        SpanReader &seek(const size_t offset)
+        {
+            if (offset > data_size)
+                throw err::EofError();
+            data_pos = offset;
+            return *this;
+        }
+
+        SpanReader &skip(const soff_t offset)
+        {
+            if (offset < 0 && static_cast<size_t>(-offset) > data_pos)
+                throw err::EofError();
+            return seek(data_pos + offset);
+        }
+
+        void read(void *destination, const size_t bytes)
+        {
+            if (bytes > left())
+                throw err::EofError();
+            std::memcpy(destination, data_ptr + data_pos, bytes);
+            data_pos += bytes;
+        }
+
+        // Skips given number of bytes and returns a pointer to them, valid
+        // for as long as the data the reader was made from.
+        const u8 *read_ptr(const size_t bytes)
+        {
+            if (bytes > left())
+                throw err::EofError();
+            const auto start = data_ptr + data_pos;
+            data_pos += bytes;
+            return start;
+        }
+
+        bstr read(const size_t bytes)
+        {
+            if (bytes > left())
+                throw err::EofError();
+            const auto start = data_ptr + data_pos;
+            data_pos += bytes;
+            return bstr(start, bytes);
+        }
+
+        bstr read_to_eof()
+        {
+            return read(left());
+        }
+
+        bstr read_to_zero()
+        {
+            const auto start = data_ptr + data_pos;
+            const auto end = data_ptr + data_size;
+            auto zero = start;
+            while (zero != end && *zero)
+                zero++;
+            data_pos = (zero == end ? zero : zero + 1) - data_ptr;
+            return bstr(start, zero - start);
+        }
+
+        bstr read_to_zero(const size_t bytes)
+        {
+            if (bytes > left())
+                throw err::EofError();
+            const auto start = data_ptr + data_pos;
+            data_pos += bytes;
+            const auto zero = std::memchr(start, 0, bytes);
+            return bstr(
+                start,
+                zero ? static_cast<const u8*>(zero) - start : bytes);
+        }
+
+        template<typename T> T read()
+        {
+            static_assert(
+                sizeof(T) == 1,
+                "For multiple bytes, must specify endianness");
+            if (data_pos >= data_size)
+                throw err::EofError();
+            return static_cast<T>(data_ptr[data_pos++]);
+        }
+
+        template<typename T> T read_le()
+        {
+            static_assert(
+                sizeof(T) > 1,
+                "Endianness does not make sense for single bytes");
+            T x;
+            read(&x, sizeof(x));
+            return algo::from_little_endian(x);
+        }
+
+        template<typename T> T read_be()
+        {
+            static_assert(
+                sizeof(T) > 1,
+                "Endianness does not make sense for single bytes");
+            T x;
+            read(&x, sizeof(x));
+            return algo::from_big_endian(x);
+        }
+
+    private:
+        std::shared_ptr<const bstr> holder;
+        const u8 *data_ptr;
+        size_t data_size;
+        size_t data_pos;
+    };
+
+} }
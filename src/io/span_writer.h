@@ -0,0 +1,126 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <cstring>
+#include "algo/endian.h"
+#include "err.h"
+#include "types.h"
+
+namespace au {
+namespace io {
+
+    // Non-virtual writer filling a preallocated buffer, e.g. a bstr sized
+    // up front or pixel rows of an image.
+    class SpanWriter final
+    {
+    public:
+        SpanWriter(u8 *data, const size_t size)
+            : data_ptr(data), data_size(size), data_pos(0)
+        {
+        }
+
+        SpanWriter(bstr &data) : SpanWriter(data.get<u8>(), data.size())
+        {
+        }
+
+        size_t size() const
+        {
+            return data_size;
+        }
+
+        size_t pos() const
+        {
+            return data_pos;
+        }
+
+        size_t left() const
+        {
+            return data_size - data_pos;
+        }
+
+        bool eof() const
+        {
+            return data_pos == data_size;
+        }
+
+        SpanWriter &seek(const size_t offset)
+        {
+            if (offset > data_size)
+                throw err::EofError();
+            data_pos = offset;
+            return *this;
+        }
+
+        SpanWriter &skip(const soff_t offset)
+        {
+            if (offset < 0 && static_cast<size_t>(-offset) > data_pos)
+                throw err::EofError();
+            return seek(data_pos + offset);
+        }
+
+        SpanWriter &write(const void *source, const size_t bytes)
+        {
+            if (bytes > left())
+                throw err::EofError();
+            std::memcpy(data_ptr + data_pos, source, bytes);
+            data_pos += bytes;
+            return *this;
+        }
+
+        SpanWriter &write(const bstr &bytes)
+        {
+            return write(bytes.get<u8>(), bytes.size());
+        }
+
+        template<typename T> SpanWriter &write(const T x)
+        {
+            static_assert(
+                sizeof(T) == 1,
+                "For multiple bytes, must specify endianness");
+            if (data_pos >= data_size)
+                throw err::EofError();
+            data_ptr[data_pos++] = static_cast<u8>(x);
+            return *this;
+        }
+
+        template<typename T> SpanWriter &write_le(const T x)
+        {
+            static_assert(
+                sizeof(T) > 1,
+                "Endianness does not make sense for single bytes");
+            const auto y = algo::to_little_endian(x);
+            return write(&y, sizeof(T));
+        }
+
+        template<typename T> SpanWriter &write_be(const T x)
+        {
+            static_assert(
+                sizeof(T) > 1,
+                "Endianness does not make sense for single bytes");
+            const auto y = algo::to_big_endian(x);
+            return write(&y, sizeof(T));
+        }
+
+    private:
+        u8 *data_ptr;
+        size_t data_size;
+        size_t data_pos;
+    };
+
+} }
@@ -20,6 +20,7 @@
 #include <map>
 #include <string>
 #include "algo/any.h"
+#include "algo/key_trial.h"
 #include "arg_parser.h"
 #include "arg_parser_decorator.h"
 #include "err.h"
@@ -36,9 +37,39 @@ namespace au {
     class BasePluginManager
     {
     public:
+        // Makes get() on this thread return given plugin, regardless of
+        // what was picked on the command line. Used to try plugins out.
+        class ScopedSelection final
+        {
+        public:
+            ScopedSelection(
+                const BasePluginManager &plugin_manager,
+                const std::string &name)
+            {
+                auto &selection = get_thread_selection();
+                previous_plugin_manager = selection.plugin_manager;
+                previous_name = selection.name;
+                selection.plugin_manager = &plugin_manager;
+                selection.name = name;
+            }
+
+            ~ScopedSelection()
+            {
+                auto &selection = get_thread_selection();
+                selection.plugin_manager = previous_plugin_manager;
+                selection.name = previous_name;
+            }
+
+        private:
+            const BasePluginManager *previous_plugin_manager;
+            std::string previous_name;
+        };
+
         BasePluginManager() : BasePluginManager("--plugin") {}
         BasePluginManager(const std::string &option_name)
-            : option_name(option_name) {}
+            : option_name(option_name),
+                auto_detect(false),
+                auto_detection_supported(false) {}
 
         virtual ~BasePluginManager() {}
 
@@ -53,33 +84,103 @@ namespace au {
                         ->set_description(description);
                     for (const auto &def : definitions)
                         sw->add_possible_value(def->name, def->description);
+                    if (auto_detection_supported)
+                    {
+                        sw->add_possible_value(
+                            "auto",
+                            "Try all plugins and use the first that works");
+                    }
                 },
                 [this](const ArgParser &arg_parser)
                 {
                     if (arg_parser.has_switch(option_name))
                         set(arg_parser.get_switch(option_name));
-                });
+                },
+                this);
         }
 
         inline bool is_set() const
         {
-            return !used_value_name.empty();
+            return !get_selected_name().empty();
+        }
+
+        inline bool is_auto() const
+        {
+            return auto_detect;
+        }
+
+        // Offers --plugin=auto. Only for decoders that can reliably tell
+        // the right plugin from a wrong one, see
+        // BaseArchiveDecoder::is_plugin_match().
+        inline void enable_auto_detection()
+        {
+            auto_detection_supported = true;
+        }
+
+        inline const std::string &get_selected_name() const
+        {
+            const auto &selection = get_thread_selection();
+            if (selection.plugin_manager == this)
+                return selection.name;
+            return used_value_name;
         }
 
         inline void set(const std::string &name)
         {
+            if (name == "auto" && auto_detection_supported)
+            {
+                used_value_name.clear();
+                auto_detect = true;
+                return;
+            }
             for (const auto &def : definitions)
             {
                 if (def->name == name)
                 {
                     used_value_name = name;
+                    auto_detect = false;
                     return;
                 }
             }
             throw err::UsageError("Unrecognized plugin: " + name);
         }
 
+        // Runs given trial once per plugin, with get() resolving to the
+        // plugin being tried, and returns the name of the first plugin
+        // (in definition order) for which it returned true. Trials run on
+        // the calling thread, which is already one of the unpacker's
+        // workers.
+        inline std::string detect(const std::function<bool()> &trial) const
+        {
+            std::vector<std::string> names;
+            for (const auto &def : definitions)
+                names.push_back(def->name);
+            const auto index = algo::find_first_match(
+                names.size(),
+                [&](const size_t i)
+                {
+                    ScopedSelection selection(*this, names[i]);
+                    return trial();
+                },
+                1);
+            if (index == names.size())
+                throw err::RecognitionError("No plugin matches this file");
+            return names[index];
+        }
+
     protected:
+        struct Selection final
+        {
+            const BasePluginManager *plugin_manager;
+            std::string name;
+        };
+
+        static Selection &get_thread_selection()
+        {
+            static thread_local Selection selection {nullptr, ""};
+            return selection;
+        }
+
         inline void add_impl(
             const std::string &name,
             const std::string &description,
@@ -102,12 +203,19 @@ namespace au {
             for (const auto &def : definitions)
                 if (def->name == check)
                     return def->value;
+            if (auto_detect)
+            {
+                throw err::UsageError(
+                    "This format doesn't support plugin autodetection.");
+            }
             throw err::UsageError("No plugin was selected.");
         }
 
         std::string option_name;
         std::vector<std::unique_ptr<PluginDefinition>> definitions;
         std::string used_value_name;
+        bool auto_detect;
+        bool auto_detection_supported;
     };
 
     template<typename T> class PluginManager final : public BasePluginManager
@@ -132,7 +240,7 @@ namespace au {
 
         inline T get() const
         {
-            const algo::any &ret = get_impl(used_value_name);
+            const algo::any &ret = get_impl(get_selected_name());
             return ret.template get<T>();
         }
 
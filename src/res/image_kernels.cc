@@ -0,0 +1,210 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#include "res/image_kernels.h"
+#include <stdexcept>
+#include "algo/range.h"
+#include "err.h"
+
+using namespace au;
+using namespace au::res;
+
+static u8 *get_row(Image &image, const size_t y, const size_t channel)
+{
+    return &image.at(0, y)[channel];
+}
+
+static void check_channel(const size_t channel)
+{
+    if (channel >= 4)
+        throw std::logic_error("Invalid channel index");
+}
+
+// Image doesn't allow empty dimensions today, but an empty image would have
+// no rows for get_row() to point at.
+static bool is_empty(const Image &image)
+{
+    return !image.width() || !image.height();
+}
+
+// Instantiated per kind so that the inner loops don't branch.
+template<DeltaKind kind> static inline u8 reconstruct(
+    const u8 prediction, const u8 residual)
+{
+    return kind == DeltaKind::Add
+        ? prediction + residual
+        : prediction - residual;
+}
+
+template<DeltaKind kind> static void apply_horizontal_delta_impl(
+    Image &image, const size_t channel)
+{
+    const auto width = image.width();
+    for (const auto y : algo::range(image.height()))
+    {
+        auto row = get_row(image, y, channel);
+        for (const auto x : algo::range(1, width))
+            row[x * 4] = reconstruct<kind>(row[(x - 1) * 4], row[x * 4]);
+    }
+}
+
+template<DeltaKind kind> static void apply_vertical_delta_impl(
+    Image &image, const size_t channel)
+{
+    const auto width = image.width();
+    for (const auto y : algo::range(1, image.height()))
+    {
+        const auto prev_row = get_row(image, y - 1, channel);
+        auto row = get_row(image, y, channel);
+        for (const auto x : algo::range(width))
+            row[x * 4] = reconstruct<kind>(prev_row[x * 4], row[x * 4]);
+    }
+}
+
+template<DeltaKind kind> static void apply_average_delta_impl(
+    Image &image, const size_t channel)
+{
+    const auto width = image.width();
+    auto row = get_row(image, 0, channel);
+    for (const auto x : algo::range(1, width))
+        row[x * 4] = reconstruct<kind>(row[(x - 1) * 4], row[x * 4]);
+
+    for (const auto y : algo::range(1, image.height()))
+    {
+        const auto prev_row = get_row(image, y - 1, channel);
+        row = get_row(image, y, channel);
+        row[0] = reconstruct<kind>(prev_row[0], row[0]);
+        for (const auto x : algo::range(1, width))
+        {
+            const u8 prediction = (row[(x - 1) * 4] + prev_row[x * 4]) / 2;
+            row[x * 4] = reconstruct<kind>(prediction, row[x * 4]);
+        }
+    }
+}
+
+void res::scatter_channel(
+    Image &image,
+    const size_t channel,
+    const u8 *input,
+    const size_t input_size,
+    const size_t input_stride)
+{
+    check_channel(channel);
+    if (is_empty(image))
+        return;
+    const auto width = image.width();
+    const auto height = image.height();
+    if (input_stride < width
+        || input_size < (height - 1) * input_stride + width)
+    {
+        throw err::BadDataSizeError();
+    }
+    for (const auto y : algo::range(height))
+    {
+        const auto input_row = input + y * input_stride;
+        auto row = get_row(image, y, channel);
+        for (const auto x : algo::range(width))
+            row[x * 4] = input_row[x];
+    }
+}
+
+void res::fill_channel(Image &image, const size_t channel, const u8 value)
+{
+    check_channel(channel);
+    for (auto &pixel : image)
+        pixel[channel] = value;
+}
+
+size_t res::scatter_channel_blocks_2x2(
+    Image &image,
+    const size_t channel,
+    const u8 *input,
+    const size_t input_size)
+{
+    check_channel(channel);
+    if (is_empty(image))
+        return 0;
+    const auto width = image.width();
+    const auto height = image.height();
+    const auto blocks_x = (width + 1) / 2;
+    const auto blocks_y = (height + 1) / 2;
+    const auto size = blocks_x * blocks_y * 4;
+    if (input_size < size)
+        throw err::EofError();
+
+    for (const auto block_y : algo::range(blocks_y))
+    {
+        const size_t y = block_y * 2;
+        const auto has_lower_row = y + 1 < height;
+        auto upper_row = get_row(image, y, channel);
+        auto lower_row = has_lower_row
+            ? get_row(image, y + 1, channel)
+            : nullptr;
+        for (const auto block_x : algo::range(blocks_x))
+        {
+            const size_t x = block_x * 2;
+            const auto has_right_column = x + 1 < width;
+            upper_row[x * 4] = input[0];
+            if (has_lower_row)
+                lower_row[x * 4] = input[1];
+            if (has_right_column)
+            {
+                upper_row[(x + 1) * 4] = input[2];
+                if (has_lower_row)
+                    lower_row[(x + 1) * 4] = input[3];
+            }
+            input += 4;
+        }
+    }
+    return size;
+}
+
+void res::apply_horizontal_delta(
+    Image &image, const size_t channel, const DeltaKind kind)
+{
+    check_channel(channel);
+    if (is_empty(image))
+        return;
+    if (kind == DeltaKind::Add)
+        apply_horizontal_delta_impl<DeltaKind::Add>(image, channel);
+    else
+        apply_horizontal_delta_impl<DeltaKind::Subtract>(image, channel);
+}
+
+void res::apply_vertical_delta(
+    Image &image, const size_t channel, const DeltaKind kind)
+{
+    check_channel(channel);
+    if (is_empty(image))
+        return;
+    if (kind == DeltaKind::Add)
+        apply_vertical_delta_impl<DeltaKind::Add>(image, channel);
+    else
+        apply_vertical_delta_impl<DeltaKind::Subtract>(image, channel);
+}
+
+void res::apply_average_delta(
+    Image &image, const size_t channel, const DeltaKind kind)
+{
+    check_channel(channel);
+    if (is_empty(image))
+        return;
+    if (kind == DeltaKind::Add)
+        apply_average_delta_impl<DeltaKind::Add>(image, channel);
+    else
+        apply_average_delta_impl<DeltaKind::Subtract>(image, channel);
+}
@@ -0,0 +1,72 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include "res/image.h"
+
+namespace au {
+namespace res {
+
+    // Whole-image passes over a single channel (0=B, 1=G, 2=R, 3=A) for
+    // decoders that store pixels as planes or as per-channel residuals.
+    // They walk the pixel buffer row by row instead of going through
+    // Image::at() for every byte.
+
+    enum class DeltaKind : u8
+    {
+        Add,      // value = prediction + residual
+        Subtract, // value = prediction - residual
+    };
+
+    // Copies width*height bytes into given channel. Row y is taken from
+    // input + y * input_stride, which covers both plain planes (stride =
+    // width) and row-interleaved planes (stride = width * channels).
+    void scatter_channel(
+        Image &image,
+        const size_t channel,
+        const u8 *input,
+        const size_t input_size,
+        const size_t input_stride);
+
+    // Fills given channel with a constant, e.g. opaque alpha.
+    void fill_channel(Image &image, const size_t channel, const u8 value);
+
+    // Copies a channel stored as 2x2 blocks, each laid out as top-left,
+    // bottom-left, top-right, bottom-right. Odd edges are padded to full
+    // blocks. Returns the number of bytes consumed.
+    size_t scatter_channel_blocks_2x2(
+        Image &image,
+        const size_t channel,
+        const u8 *input,
+        const size_t input_size);
+
+    // Undoes per-row prediction from the left neighbor.
+    void apply_horizontal_delta(
+        Image &image, const size_t channel, const DeltaKind kind);
+
+    // Undoes per-column prediction from the upper neighbor.
+    void apply_vertical_delta(
+        Image &image, const size_t channel, const DeltaKind kind);
+
+    // Undoes prediction from the average of the left and upper neighbors.
+    // The first row is predicted from the left, the first column from above
+    // and the top-left pixel is kept as is.
+    void apply_average_delta(
+        Image &image, const size_t channel, const DeltaKind kind);
+
+} }
@@ -18,7 +18,6 @@
 #include "virtual_file_system.h"
 #include <map>
 #include <mutex>
-#include <set>
 #include "algo/str.h"
 #include "err.h"
 #include "io/file_system.h"
@@ -27,7 +26,9 @@ using namespace au;
 
 static std::mutex mutex;
 static std::map<io::path, std::function<std::unique_ptr<io::File>()>> factories;
-static std::set<io::path> directories;
+// directories may be registered by several users at once, so they're
+// reference counted
+static std::map<io::path, size_t> directories;
 static bool enabled = true;
 
 void VirtualFileSystem::disable()
@@ -67,13 +68,15 @@ void VirtualFileSystem::register_directory(const io::path &path)
 {
     std::unique_lock<std::mutex> lock(mutex);
     if (enabled)
-        directories.insert(path);
+        directories[path]++;
 }
 
 void VirtualFileSystem::unregister_directory(const io::path &path)
 {
     std::unique_lock<std::mutex> lock(mutex);
-    directories.erase(path);
+    const auto it = directories.find(path);
+    if (it != directories.end() && !--it->second)
+        directories.erase(it);
 }
 
 std::unique_ptr<io::File> VirtualFileSystem::get_by_stem(
@@ -88,8 +91,8 @@ std::unique_ptr<io::File> VirtualFileSystem::get_by_stem(
         if (kv.first.stem() == check)
             return kv.second();
 
-    for (const auto &directory : directories)
-    for (const auto &other_path : io::recursive_directory_range(directory))
+    for (const auto &kv : directories)
+    for (const auto &other_path : io::recursive_directory_range(kv.first))
         if (algo::lower(other_path.stem()) == check)
             return std::make_unique<io::File>(other_path, io::FileMode::Read);
 
@@ -108,8 +111,8 @@ std::unique_ptr<io::File> VirtualFileSystem::get_by_name(
         if (kv.first.name() == check)
             return kv.second();
 
-    for (const auto &directory : directories)
-    for (const auto &other_path : io::recursive_directory_range(directory))
+    for (const auto &kv : directories)
+    for (const auto &other_path : io::recursive_directory_range(kv.first))
         if (algo::lower(other_path.name()) == check)
             return std::make_unique<io::File>(other_path, io::FileMode::Read);
 
@@ -126,8 +129,8 @@ std::unique_ptr<io::File> VirtualFileSystem::get_by_path(const io::path &path)
     if (factories.find(check) != factories.end())
         return factories[check]();
 
-    for (const auto &directory : directories)
-    for (const auto &other_path : io::recursive_directory_range(directory))
+    for (const auto &kv : directories)
+    for (const auto &other_path : io::recursive_directory_range(kv.first))
     {
         if (io::path(algo::lower(other_path.str())) == check)
             return std::make_unique<io::File>(other_path, io::FileMode::Read);
@@ -18,6 +18,7 @@
 #include "algo/crypt/lcg.h"
 #include "test_support/catch.h"
 
+using namespace au;
 using namespace au::algo::crypt;
 
 TEST_CASE("Linear congruential generators", "[algo][crypt]")
@@ -60,4 +61,69 @@ TEST_CASE("Linear congruential generators", "[algo][crypt]")
         REQUIRE(l.next() == 179);
         REQUIRE(l.next() == 38);
     }
+
+    SECTION("Bulk output matches single outputs")
+    {
+        for (const auto kind : {
+            LcgKind::MicrosoftVisualC,
+            LcgKind::ParkMiller,
+            LcgKind::ParkMillerRevised})
+        {
+            Lcg l1(kind, 0xDEADBEEF);
+            Lcg l2(kind, 0xDEADBEEF);
+            std::vector<u32> expected(100);
+            for (auto &value : expected)
+                value = l1.next();
+            std::vector<u32> actual(100);
+            l2.fill(actual.data(), 3);
+            l2.fill(actual.data() + 3, 16);
+            l2.fill(actual.data() + 19, 81);
+            REQUIRE(actual == expected);
+            REQUIRE(l1.next() == l2.next());
+        }
+    }
+}
+
+TEST_CASE("LCG state iteration", "[algo][crypt]")
+{
+    for (const auto count : {0, 5, 8, 29})
+    {
+        std::vector<u32> expected(count);
+        u32 expected_state = 0x12345678;
+        for (auto &value : expected)
+        {
+            expected_state = expected_state * 0x343FD + 0x269EC3;
+            value = expected_state;
+        }
+        std::vector<u32> actual(count);
+        u32 actual_state = 0x12345678;
+        for_each_lcg_state<u32>(
+            actual_state,
+            0x343FD,
+            0x269EC3,
+            count,
+            [&](const size_t i, const u32 state) { actual[i] = state; });
+        REQUIRE(actual == expected);
+        REQUIRE(actual_state == expected_state);
+
+        const u64 multiplier = 6364136223846793005;
+        const u64 increment = 1442695040888963407;
+        std::vector<u64> expected64(count);
+        u64 expected_state64 = 1;
+        for (auto &value : expected64)
+        {
+            expected_state64 = expected_state64 * multiplier + increment;
+            value = expected_state64;
+        }
+        std::vector<u64> actual64(count);
+        u64 actual_state64 = 1;
+        for_each_lcg_state(
+            actual_state64,
+            multiplier,
+            increment,
+            count,
+            [&](const size_t i, const u64 state) { actual64[i] = state; });
+        REQUIRE(actual64 == expected64);
+        REQUIRE(actual_state64 == expected_state64);
+    }
 }
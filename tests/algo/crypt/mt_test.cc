@@ -0,0 +1,66 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#include "algo/crypt/mt.h"
+#include "algo/range.h"
+#include "test_support/catch.h"
+
+using namespace au;
+using namespace au::algo::crypt;
+
+TEST_CASE("Mersenne Twister", "[algo][crypt]")
+{
+    SECTION("Reference outputs")
+    {
+        auto mt = MersenneTwister::Improved(5489);
+        REQUIRE(mt->next_u32() == 3499211612);
+        for (const auto i : algo::range(9998))
+            mt->next_u32();
+        REQUIRE(mt->next_u32() == 4123659995);
+    }
+
+    SECTION("Bulk output matches single outputs")
+    {
+        auto mt1 = MersenneTwister::Classic(0xDEADBEEF);
+        auto mt2 = MersenneTwister::Classic(0xDEADBEEF);
+        std::vector<u32> expected(2000);
+        for (auto &value : expected)
+            value = mt1->next_u32();
+        std::vector<u32> actual(2000);
+        mt2->fill(actual.data(), 5);
+        mt2->fill(actual.data() + 5, 1000);
+        mt2->fill(actual.data() + 1005, 995);
+        REQUIRE(actual == expected);
+        REQUIRE(mt1->next_u32() == mt2->next_u32());
+    }
+
+    SECTION("XOR stream matches single outputs")
+    {
+        auto mt1 = MersenneTwister::Knuth(0xDEADBEEF);
+        auto mt2 = MersenneTwister::Knuth(0xDEADBEEF);
+        bstr expected(1500);
+        for (const auto i : algo::range(expected.size()))
+            expected[i] = i ^ mt1->next_u32();
+        bstr actual(1500);
+        for (const auto i : algo::range(actual.size()))
+            actual[i] = i;
+        mt2->xor_stream(actual.get<u8>(), 700);
+        mt2->xor_stream(actual.get<u8>() + 700, 800);
+        REQUIRE(actual == expected);
+        REQUIRE(mt1->next_u32() == mt2->next_u32());
+    }
+}
@@ -0,0 +1,81 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#include "algo/crypt/xor.h"
+#include "algo/range.h"
+#include "test_support/catch.h"
+
+using namespace au;
+using namespace au::algo::crypt;
+
+static bstr make_input(const size_t size)
+{
+    bstr input(size);
+    for (const auto i : algo::range(size))
+        input[i] = i * 7 + 3;
+    return input;
+}
+
+TEST_CASE("XOR kernels", "[algo][crypt]")
+{
+    SECTION("Repeating key")
+    {
+        const auto key = "\x01\x02\x03"_b;
+        for (const auto key_pos : {0, 2, 4})
+        {
+            auto actual = make_input(11);
+            auto expected = actual;
+            for (const auto i : algo::range(expected.size()))
+                expected[i] ^= key[(key_pos + i) % key.size()];
+            xor_repeating(actual, key, key_pos);
+            REQUIRE(actual == expected);
+        }
+        auto empty = ""_b;
+        xor_repeating(empty, ""_b);
+        auto data = "test"_b;
+        REQUIRE_THROWS(xor_repeating(data, ""_b));
+    }
+
+    SECTION("Incrementing key")
+    {
+        auto actual = make_input(300);
+        auto expected = actual;
+        u8 key = 0xC5;
+        for (auto &c : expected)
+        {
+            c ^= key;
+            key += 0x5C;
+        }
+        REQUIRE(xor_incrementing(
+            actual.get<u8>(), actual.size(), 0xC5, 0x5C) == key);
+        REQUIRE(actual == expected);
+    }
+
+    SECTION("Reverse interleaved blocks")
+    {
+        const auto input = "\x00\x01\x02\x03\x04"_b;
+        bstr output(input.size());
+        const auto key = xor_incrementing_reverse_interleaved(
+            input.get<u8>(), output.get<u8>(), input.size(), 0, 0);
+        REQUIRE(key == 0);
+        REQUIRE(output == "\x02\x04\x01\x03\x00"_b);
+
+        REQUIRE(xor_incrementing_reverse_interleaved(
+            input.get<u8>(), output.get<u8>(), input.size(), 1, 2) == 11);
+        REQUIRE(output == "\x07\x0D\x02\x04\x01"_b);
+    }
+}
@@ -0,0 +1,96 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#include "algo/key_trial.h"
+#include <atomic>
+#include "plugin_manager.h"
+#include "test_support/catch.h"
+
+using namespace au;
+
+TEST_CASE("Key trials", "[algo]")
+{
+    SECTION("Finds the first match in order")
+    {
+        for (const auto max_threads : {1, 4})
+        {
+            const auto index = algo::find_first_match(
+                100,
+                [](const size_t i) { return i == 37 || i == 60; },
+                max_threads);
+            REQUIRE(index == 37);
+        }
+    }
+
+    SECTION("Treats exceptions as misses")
+    {
+        const auto index = algo::find_first_match(
+            10,
+            [](const size_t i) -> bool
+            {
+                if (i < 5)
+                    throw std::runtime_error("bad key");
+                return true;
+            },
+            4);
+        REQUIRE(index == 5);
+    }
+
+    SECTION("Reports no match")
+    {
+        std::atomic<size_t> trial_count(0);
+        const auto index = algo::find_first_match(
+            10, [&](const size_t) { trial_count++; return false; });
+        REQUIRE(index == 10);
+        REQUIRE(trial_count == 10);
+    }
+
+    SECTION("Works on candidate lists")
+    {
+        const std::vector<std::string> candidates = {"abc", "def", "ghi"};
+        const auto match = algo::find_first_match(
+            candidates, [](const std::string &s) { return s[0] > 'b'; });
+        REQUIRE(match);
+        REQUIRE(*match == "def");
+    }
+}
+
+TEST_CASE("Plugin autodetection", "[core]")
+{
+    PluginManager<int> plugin_manager;
+    plugin_manager.add("one", "First", 1);
+    plugin_manager.add("two", "Second", 2);
+    plugin_manager.add("three", "Third", 3);
+    REQUIRE_THROWS(plugin_manager.set("auto"));
+    plugin_manager.enable_auto_detection();
+    plugin_manager.set("auto");
+    REQUIRE(plugin_manager.is_auto());
+    REQUIRE(!plugin_manager.is_set());
+    REQUIRE_THROWS(plugin_manager.get());
+
+    const auto name = plugin_manager.detect(
+        [&]() { return plugin_manager.get() >= 2; });
+    REQUIRE(name == "two");
+    REQUIRE_THROWS(plugin_manager.detect([]() { return false; }));
+
+    {
+        PluginManager<int>::ScopedSelection selection(plugin_manager, name);
+        REQUIRE(plugin_manager.is_set());
+        REQUIRE(plugin_manager.get() == 2);
+    }
+    REQUIRE(!plugin_manager.is_set());
+}
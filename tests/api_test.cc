@@ -0,0 +1,116 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#include "api.h"
+#include <map>
+#include <sstream>
+#include "test_support/catch.h"
+#include "test_support/file_support.h"
+#include "virtual_file_system.h"
+
+using namespace au;
+
+static const std::string path = "tests/dec/active_soft/files/adpack/test.pak";
+
+static api::Options make_options()
+{
+    api::Options options;
+    options.decoder_name = "active-soft/adpack";
+    options.enable_nested_decoding = false;
+    return options;
+}
+
+TEST_CASE("Library API", "[api]")
+{
+    SECTION("Enumerating and reading entries")
+    {
+        const api::Archive archive(path, make_options());
+        REQUIRE(archive.get_decoder_name() == "active-soft/adpack");
+        const auto &entries = archive.get_entries();
+        REQUIRE(entries.size() == 2);
+        REQUIRE(entries[0].path == io::path("123.txt"));
+        REQUIRE(entries[0].offset == 80);
+        REQUIRE(entries[0].size == 10);
+        REQUIRE(entries[1].path == io::path("abc.xyz"));
+
+        REQUIRE(archive.read_entry(0) == "1234567890"_b);
+
+        std::stringstream stream;
+        archive.read_entry(1, stream);
+        REQUIRE(stream.str() == "abcdefghijklmnopqrstuvwxyz");
+
+        u8 buffer[4];
+        REQUIRE(archive.read_entry(0, buffer, sizeof(buffer)) == 10);
+        REQUIRE(bstr(buffer, sizeof(buffer)) == "1234"_b);
+
+        REQUIRE_THROWS(archive.read_entry(2));
+    }
+
+    SECTION("Reading from memory")
+    {
+        const auto input_file = tests::file_from_path(path);
+        const api::Archive archive(
+            "test.pak",
+            input_file->stream.seek(0).read_to_eof(),
+            make_options());
+        REQUIRE(archive.get_entries().size() == 2);
+        REQUIRE(archive.read_entry(1) == "abcdefghijklmnopqrstuvwxyz"_b);
+    }
+
+    SECTION("Unrecognized input")
+    {
+        REQUIRE_THROWS(
+            api::Archive("garbage.dat", "garbage"_b, make_options()));
+    }
+
+    SECTION("Bulk unpacking")
+    {
+        std::map<std::string, bstr> outputs;
+        REQUIRE(api::unpack(
+            {path},
+            [&](const io::path &output_path, const bstr &data)
+            {
+                outputs[output_path.name()] = data;
+            },
+            make_options()));
+        REQUIRE(outputs.size() == 2);
+        REQUIRE(outputs.at("123.txt") == "1234567890"_b);
+        REQUIRE(outputs.at("abc.xyz") == "abcdefghijklmnopqrstuvwxyz"_b);
+    }
+
+    SECTION("Input directories are visible only while in use")
+    {
+        {
+            const api::Archive archive(path, make_options());
+            REQUIRE(VirtualFileSystem::get_by_name("test.pak"));
+        }
+        REQUIRE(!VirtualFileSystem::get_by_name("test.pak"));
+
+        auto options = make_options();
+        options.thread_count = 1;
+        auto visible = true;
+        api::unpack(
+            {path},
+            [&](const io::path &, const bstr &)
+            {
+                visible &= VirtualFileSystem::get_by_name("test.pak") != nullptr;
+            },
+            options);
+        REQUIRE(visible);
+        REQUIRE(!VirtualFileSystem::get_by_name("test.pak"));
+    }
+}
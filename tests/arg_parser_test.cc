@@ -58,11 +58,24 @@ TEST_CASE("ArgParser", "[core]")
         REQUIRE(!ap.has_switch("long"));
     }
 
+    SECTION("Repeated switches retrieval")
+    {
+        ArgParser ap;
+        ap.register_switch({"--long"});
+        ap.parse(std::vector<std::string>{"--long=first", "--long=second"});
+        REQUIRE(ap.get_switch("long") == "second");
+        const auto values = ap.get_switches("long");
+        REQUIRE(values.size() == 2);
+        REQUIRE(values[0] == "first");
+        REQUIRE(values[1] == "second");
+    }
+
     SECTION("Querying undefined switches throws exceptions")
     {
         ArgParser ap;
         ap.parse(std::vector<std::string>{});
         REQUIRE_THROWS(ap.get_switch("long"));
+        REQUIRE_THROWS(ap.get_switches("long"));
         REQUIRE_THROWS(ap.has_switch("long"));
     }
 
@@ -0,0 +1,95 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#include "asset_cache.h"
+#include "io/file_byte_stream.h"
+#include "io/file_system.h"
+#include "test_support/catch.h"
+
+using namespace au;
+
+TEST_CASE("Asset cache", "[core]")
+{
+    AssetCache::clear();
+
+    SECTION("Values are produced once per key")
+    {
+        auto calls = 0;
+        const auto factory = [&]()
+        {
+            calls++;
+            return std::make_shared<const int>(5);
+        };
+        REQUIRE(*AssetCache::get<int>("test/key", factory) == 5);
+        REQUIRE(*AssetCache::get<int>("test/key", factory) == 5);
+        REQUIRE(calls == 1);
+        AssetCache::get<int>("test/other-key", factory);
+        REQUIRE(calls == 2);
+    }
+
+    SECTION("Same keys of different types don't collide")
+    {
+        AssetCache::get<int>(
+            "test/key", []() { return std::make_shared<const int>(5); });
+        REQUIRE(*AssetCache::get<bstr>(
+            "test/key", []() { return std::make_shared<const bstr>("x"_b); })
+                == "x"_b);
+    }
+
+    SECTION("Failures aren't cached")
+    {
+        REQUIRE_THROWS(AssetCache::get<int>(
+            "test/key",
+            []() -> std::shared_ptr<const int>
+            {
+                throw std::runtime_error("failure");
+            }));
+        REQUIRE(*AssetCache::get<int>(
+            "test/key", []() { return std::make_shared<const int>(5); })
+                == 5);
+    }
+
+    SECTION("Transient values are cleared separately")
+    {
+        auto calls = 0;
+        const auto factory = [&]()
+        {
+            calls++;
+            return std::make_shared<const int>(5);
+        };
+        AssetCache::get<int>("test/key", factory);
+        AssetCache::get_transient<int>("test/transient-key", factory);
+        AssetCache::clear_transient();
+        AssetCache::get<int>("test/key", factory);
+        REQUIRE(calls == 2);
+        AssetCache::get_transient<int>("test/transient-key", factory);
+        REQUIRE(calls == 3);
+    }
+
+    SECTION("File identities change with the file")
+    {
+        const io::path path = "test.asset";
+        io::FileByteStream(path, io::FileMode::Write).write("abc"_b);
+        const auto identity = AssetCache::identify_file(path);
+        REQUIRE(AssetCache::identify_file(path) == identity);
+        io::FileByteStream(path, io::FileMode::Write).write("abcd"_b);
+        REQUIRE(AssetCache::identify_file(path) != identity);
+        io::remove(path);
+    }
+
+    AssetCache::clear();
+}
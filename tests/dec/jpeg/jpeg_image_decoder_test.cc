@@ -16,16 +16,118 @@
 // along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
 
 #include "dec/jpeg/jpeg_image_decoder.h"
+#include <jpeglib.h>
+#include "dec/base_archive_decoder.h"
 #include "io/file_byte_stream.h"
 #include "test_support/catch.h"
+#include "test_support/common.h"
 #include "test_support/decoder_support.h"
 #include "test_support/file_support.h"
+#include "test_support/flow_support.h"
 #include "test_support/image_support.h"
 
 using namespace au;
 using namespace au::dec::jpeg;
 
 static const std::string dir = "tests/dec/jpeg/files/";
+static const bstr archive_magic = "ARC\x00"_b;
+
+namespace
+{
+    // Stores everything after its magic as a single .jpg entry.
+    class TestArchiveDecoder final : public dec::BaseArchiveDecoder
+    {
+    public:
+        std::vector<std::string> get_linked_formats() const override;
+
+    protected:
+        bool is_recognized_impl(io::File &input_file) const override;
+
+        std::unique_ptr<dec::ArchiveMeta> read_meta_impl(
+            const Logger &logger, io::File &input_file) const override;
+
+        std::unique_ptr<io::File> read_file_impl(
+            const Logger &logger,
+            io::File &input_file,
+            const dec::ArchiveMeta &m,
+            const dec::ArchiveEntry &e) const override;
+    };
+}
+
+std::vector<std::string> TestArchiveDecoder::get_linked_formats() const
+{
+    return {"jpeg/jpeg"};
+}
+
+bool TestArchiveDecoder::is_recognized_impl(io::File &input_file) const
+{
+    return input_file.stream.seek(0).read(archive_magic.size())
+        == archive_magic;
+}
+
+std::unique_ptr<dec::ArchiveMeta> TestArchiveDecoder::read_meta_impl(
+    const Logger &logger, io::File &input_file) const
+{
+    auto meta = std::make_unique<dec::ArchiveMeta>();
+    auto entry = std::make_unique<dec::PlainArchiveEntry>();
+    entry->path = "image.jpg";
+    entry->offset = archive_magic.size();
+    entry->size = input_file.stream.size() - archive_magic.size();
+    meta->entries.push_back(std::move(entry));
+    return meta;
+}
+
+std::unique_ptr<io::File> TestArchiveDecoder::read_file_impl(
+    const Logger &logger,
+    io::File &input_file,
+    const dec::ArchiveMeta &,
+    const dec::ArchiveEntry &e) const
+{
+    const auto entry = static_cast<const dec::PlainArchiveEntry*>(&e);
+    const auto data = input_file.stream.seek(entry->offset).read(entry->size);
+    return std::make_unique<io::File>(entry->path, data);
+}
+
+static std::shared_ptr<JpegImageDecoder> create_decoder(
+    const std::vector<std::string> &args)
+{
+    auto decoder = std::make_shared<JpegImageDecoder>();
+    ArgParser arg_parser;
+    for (const auto &decorator : decoder->get_arg_parser_decorators())
+        decorator.register_cli_options(arg_parser);
+    arg_parser.parse(args);
+    for (const auto &decorator : decoder->get_arg_parser_decorators())
+        decorator.parse_cli_options(arg_parser);
+    return decoder;
+}
+
+// Decodes the input the way the decoder did before it learned to write
+// BGRA scanlines directly.
+static res::Image decode_via_rgb(const bstr &input)
+{
+    jpeg_decompress_struct info;
+    jpeg_error_mgr err;
+    info.err = jpeg_std_error(&err);
+    jpeg_create_decompress(&info);
+    jpeg_mem_src(
+        &info,
+        const_cast<u8*>(input.get<u8>()),
+        input.size());
+    jpeg_read_header(&info, TRUE);
+    info.out_color_space = JCS_RGB;
+    jpeg_start_decompress(&info);
+    const auto width = info.output_width;
+    const auto height = info.output_height;
+    bstr raw_data(width * height * 3);
+    while (info.output_scanline < height)
+    {
+        JSAMPROW row = raw_data.get<u8>() + info.output_scanline * width * 3;
+        jpeg_read_scanlines(&info, &row, 1);
+    }
+    jpeg_finish_decompress(&info);
+    jpeg_destroy_decompress(&info);
+    return res::Image(width, height, raw_data, res::PixelFormat::RGB888);
+}
 
 TEST_CASE("JPEG 24-bit images", "[dec]")
 {
@@ -51,3 +153,44 @@ TEST_CASE("JPEG 8-bit images", "[dec]")
     auto actual_image = tests::decode(decoder, *input_file);
     tests::compare_images(actual_image, *expected_file);
 }
+
+TEST_CASE("JPEG images decode to the same pixels as via RGB", "[dec]")
+{
+    const auto input_file = tests::file_from_path(dir + "reimu_opaque.jpg");
+    const auto expected_image
+        = decode_via_rgb(input_file->stream.seek(0).read_to_eof());
+
+    const auto decoder = JpegImageDecoder();
+    const auto actual_image = tests::decode(decoder, *input_file);
+    tests::compare_images(actual_image, expected_image);
+}
+
+TEST_CASE("JPEG passthrough", "[dec]")
+{
+    const auto input_file = tests::file_from_path(dir + "reimu_opaque.jpg");
+    const auto input_data = input_file->stream.seek(0).read_to_eof();
+
+    SECTION("Disabled by default")
+    {
+        REQUIRE(!create_decoder({})->can_pass_through());
+    }
+
+    SECTION("Nested files are saved byte for byte")
+    {
+        const auto decoder = create_decoder({"--jpeg-passthrough"});
+        REQUIRE(decoder->can_pass_through());
+
+        auto registry = dec::Registry::create_mock();
+        registry->add_decoder(
+            "test/test-archive",
+            []() { return std::make_shared<TestArchiveDecoder>(); });
+        registry->add_decoder("jpeg/jpeg", [&]() { return decoder; });
+
+        io::File archive_file("archive.arc", archive_magic + input_data);
+        const auto saved_files
+            = tests::flow_unpack(*registry, true, archive_file);
+        REQUIRE(saved_files.size() == 1);
+        tests::compare_paths(saved_files[0]->path, "archive.arc/image.jpg");
+        REQUIRE(saved_files[0]->stream.read_to_eof() == input_data);
+    }
+}
@@ -0,0 +1,126 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#include "dec/kirikiri/cxdec.h"
+#include "algo/range.h"
+#include "test_support/catch.h"
+
+using namespace au;
+using namespace au::dec::kirikiri;
+
+namespace
+{
+    struct KeyDerivationCase final
+    {
+        u32 seed;
+        u32 parameter;
+        u32 expected_key;
+    };
+}
+
+static bstr make_control_block(const u32 seed)
+{
+    bstr control_block(4096);
+    u32 state = seed;
+    for (const auto i : algo::range(control_block.size()))
+    {
+        state = state * 0x343FD + 0x269EC3;
+        control_block[i] = state >> 16;
+    }
+    return control_block;
+}
+
+static void do_test(
+    const bstr &control_block,
+    const std::array<size_t, 3> key_derivation_order1,
+    const std::array<size_t, 8> key_derivation_order2,
+    const std::array<size_t, 6> key_derivation_order3,
+    const std::vector<KeyDerivationCase> &cases)
+{
+    for (const auto &c : cases)
+    {
+        INFO("seed " << c.seed << ", parameter " << c.parameter);
+        REQUIRE(derive_cxdec_key(
+            control_block,
+            key_derivation_order1,
+            key_derivation_order2,
+            key_derivation_order3,
+            c.seed,
+            c.parameter) == c.expected_key);
+    }
+}
+
+// The expected keys come from the previous KeyDeriver.
+TEST_CASE("KiriKiri cxdec key derivation", "[dec]")
+{
+    SECTION("Identity derivation order")
+    {
+        const std::array<size_t, 3> order1 = {0, 1, 2};
+        const std::array<size_t, 8> order2 = {0, 1, 2, 3, 4, 5, 6, 7};
+        const std::array<size_t, 6> order3 = {0, 1, 2, 3, 4, 5};
+        do_test(make_control_block(0), order1, order2, order3,
+        {
+            {0x00, 0x00000000, 0x8B15353D},
+            {0x01, 0x12345678, 0x1A94E000},
+            {0x3F, 0xFFFFFFFF, 0x926FEC00},
+            {0x55, 0x00ABCDEF, 0xD5CBF281},
+            {0x7F, 0x02000000, 0x320FE9E4},
+        });
+        do_test(make_control_block(0xDEADBEEF), order1, order2, order3,
+        {
+            {0x00, 0x00000000, 0x25621A85},
+            {0x01, 0x12345678, 0x883529C0},
+            {0x3F, 0xFFFFFFFF, 0x926FEC00},
+            {0x55, 0x00ABCDEF, 0x412703EA},
+            {0x7F, 0x02000000, 0x001FD8FC},
+        });
+    }
+
+    SECTION("Shuffled derivation order")
+    {
+        const std::array<size_t, 3> order1 = {2, 0, 1};
+        const std::array<size_t, 8> order2 = {1, 5, 0, 3, 2, 7, 6, 4};
+        const std::array<size_t, 6> order3 = {4, 5, 2, 1, 0, 3};
+        do_test(make_control_block(0), order1, order2, order3,
+        {
+            {0x00, 0x00000000, 0x216D0DC4},
+            {0x01, 0x12345678, 0xE7FA70E7},
+            {0x3F, 0xFFFFFFFF, 0x6DCDDB34},
+            {0x55, 0x00ABCDEF, 0xF5C618FB},
+            {0x7F, 0x02000000, 0x00162E26},
+        });
+        do_test(make_control_block(0xDEADBEEF), order1, order2, order3,
+        {
+            {0x00, 0x00000000, 0xB0E5EB87},
+            {0x01, 0x12345678, 0x0A1C91E7},
+            {0x3F, 0xFFFFFFFF, 0xFDA64DA5},
+            {0x55, 0x00ABCDEF, 0xE4244C54},
+            {0x7F, 0x02000000, 0x00162E26},
+        });
+    }
+
+    SECTION("Truncated control block")
+    {
+        REQUIRE_THROWS(derive_cxdec_key(
+            ""_b,
+            {0, 1, 2},
+            {0, 1, 2, 3, 4, 5, 6, 7},
+            {0, 1, 2, 3, 4, 5},
+            0,
+            0));
+    }
+}
@@ -16,6 +16,8 @@
 // along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
 
 #include "dec/kirikiri/xp3_archive_decoder.h"
+#include "algo/crypt/adler32.h"
+#include "algo/range.h"
 #include "test_support/catch.h"
 #include "test_support/decoder_support.h"
 #include "test_support/file_support.h"
@@ -76,3 +78,51 @@ TEST_CASE("KiriKiri XP3 archives", "[dec]")
         do_test("xp3-time.xp3");
     }
 }
+
+static void patch_checksum(bstr &data, const size_t offset, const bstr &content)
+{
+    const auto checksum = algo::crypt::adler32(content);
+    for (const auto i : algo::range(4))
+        data[offset + i] = checksum >> (i * 8);
+}
+
+TEST_CASE("KiriKiri XP3 plugin autodetection", "[dec]")
+{
+    Xp3ArchiveDecoder decoder;
+    decoder.plugin_manager.set("auto");
+
+    SECTION("Plugin whose output matches the adlr checksums")
+    {
+        // the test archives carry dummy checksums; put the real ones in
+        // their place
+        auto data = tests::file_from_path(dir + "xp3-v2.xp3")
+            ->stream.seek(0).read_to_eof();
+        patch_checksum(data, 197, "1234567890"_b);
+        patch_checksum(data, 313, "abcdefghijklmnopqrstuvwxyz"_b);
+        io::File input_file("xp3-v2.xp3", data);
+        const std::vector<std::shared_ptr<io::File>> expected_files
+        {
+            tests::stub_file("123.txt", "1234567890"_b),
+            tests::stub_file("abc.xyz", "abcdefghijklmnopqrstuvwxyz"_b),
+        };
+        const auto actual_files = tests::unpack(decoder, input_file);
+        tests::compare_files(actual_files, expected_files, true);
+    }
+
+    SECTION("Files too small to tell plugins apart are not enough")
+    {
+        // 123.txt is shorter than the prefix most plugins leave untouched,
+        // so only abc.xyz decides
+        auto data = tests::file_from_path(dir + "xp3-v2.xp3")
+            ->stream.seek(0).read_to_eof();
+        patch_checksum(data, 197, "1234567890"_b);
+        io::File input_file("xp3-v2.xp3", data);
+        REQUIRE_THROWS(tests::unpack(decoder, input_file));
+    }
+
+    SECTION("No plugin matches the dummy checksum")
+    {
+        const auto input_file = tests::file_from_path(dir + "xp3-v2.xp3");
+        REQUIRE_THROWS(tests::unpack(decoder, *input_file));
+    }
+}
@@ -140,5 +140,11 @@ TEST_CASE("Malie Libu archives", "[dec]")
 
         const auto actual_files = tests::unpack(decoder, input_file);
         tests::compare_files(actual_files, expected_files, true);
+
+        // without --plugin, the key is picked from the first block
+        LibuArchiveDecoder detecting_decoder;
+        REQUIRE(detecting_decoder.is_recognized(input_file));
+        tests::compare_files(
+            tests::unpack(detecting_decoder, input_file), expected_files, true);
     }
 }
@@ -16,6 +16,8 @@
 // along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
 
 #include "dec/renpy/rpa_archive_decoder.h"
+#include "dec/archive_meta_cache.h"
+#include "io/file_system.h"
 #include "test_support/catch.h"
 #include "test_support/decoder_support.h"
 #include "test_support/file_support.h"
@@ -23,9 +25,9 @@
 using namespace au;
 using namespace au::dec::renpy;
 
-static const std::string dir = "tests/dec/renpy/files/rpa/";
+static const io::path dir = "tests/dec/renpy/files/rpa/";
 
-static void test(const std::string &path)
+static void test(const io::path &path)
 {
     const std::vector<std::shared_ptr<io::File>> expected_files
     {
@@ -33,7 +35,7 @@ static void test(const std::string &path)
         tests::stub_file("abc.txt", "123"_b),
     };
     const auto decoder = RpaArchiveDecoder();
-    const auto input_file = tests::file_from_path(dir + path);
+    const auto input_file = tests::file_from_path(path);
     const auto actual_files = tests::unpack(decoder, *input_file);
     tests::compare_files(actual_files, expected_files, true);
 }
@@ -42,16 +44,33 @@ TEST_CASE("Ren'py RPA archives", "[dec]")
 {
     SECTION("Version 3")
     {
-        test("v3.rpa");
+        test(dir / "v3.rpa");
     }
 
     SECTION("Version 2")
     {
-        test("v2.rpa");
+        test(dir / "v2.rpa");
     }
 
     SECTION("Data prefixes")
     {
-        test("prefixes.rpa");
+        test(dir / "prefixes.rpa");
+    }
+
+    SECTION("Metadata cache")
+    {
+        const io::path cache_dir = "meta-cache-test";
+        dec::ArchiveMetaCache::enable(cache_dir);
+        test(io::absolute(dir / "prefixes.rpa"));
+        test(io::absolute(dir / "prefixes.rpa"));
+        dec::ArchiveMetaCache::disable();
+
+        std::vector<io::path> cache_files;
+        for (const auto &path : io::directory_range(cache_dir))
+            cache_files.push_back(path);
+        for (const auto &path : cache_files)
+            io::remove(path);
+        io::remove(cache_dir);
+        REQUIRE(cache_files.size() == 1);
     }
 }
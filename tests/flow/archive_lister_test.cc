@@ -0,0 +1,73 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#include "flow/archive_lister.h"
+#include <sstream>
+#include "test_support/catch.h"
+#include "test_support/file_support.h"
+
+using namespace au;
+
+static const std::string path = "tests/dec/active_soft/files/adpack/test.pak";
+
+static std::string list(
+    const flow::PathFilter &path_filter, const flow::ListingFormat format)
+{
+    Logger logger;
+    logger.mute();
+    std::stringstream output;
+    const flow::ArchiveLister lister(
+        logger,
+        output,
+        dec::Registry::instance(),
+        path_filter,
+        format,
+        false,
+        {},
+        {"active-soft/adpack"});
+    const auto input_file = tests::file_from_path(path);
+    REQUIRE(lister.list(*input_file));
+    return output.str();
+}
+
+TEST_CASE("Archive lister", "[flow]")
+{
+    flow::PathFilter path_filter;
+
+    SECTION("Text format")
+    {
+        REQUIRE(list(path_filter, flow::ListingFormat::Text) ==
+            path + "\tactive-soft/adpack\t123.txt\toffset=80\tsize=10\n"
+            + path + "\tactive-soft/adpack\tabc.xyz\toffset=90\tsize=26\n");
+    }
+
+    SECTION("JSONL format")
+    {
+        REQUIRE(list(path_filter, flow::ListingFormat::Jsonl) ==
+            "{\"archive\":\"" + path + "\",\"decoder\":\"active-soft/adpack\","
+            "\"path\":\"123.txt\",\"offset\":80,\"size\":10}\n"
+            "{\"archive\":\"" + path + "\",\"decoder\":\"active-soft/adpack\","
+            "\"path\":\"abc.xyz\",\"offset\":90,\"size\":26}\n");
+    }
+
+    SECTION("Filtering")
+    {
+        path_filter.add_exclude_pattern("*.txt");
+        REQUIRE(list(path_filter, flow::ListingFormat::Text) ==
+            path + "\tactive-soft/adpack\tabc.xyz\toffset=90\tsize=26\n");
+    }
+}
@@ -0,0 +1,47 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#include "flow/daemon.h"
+#include "test_support/catch.h"
+
+using namespace au;
+
+TEST_CASE("Removing daemon switches", "[flow]")
+{
+    using arguments = std::vector<std::string>;
+
+    SECTION("Value attached")
+    {
+        REQUIRE(flow::remove_switch({"a", "--client=x", "b"}, "client")
+            == arguments({"a", "b"}));
+        REQUIRE(flow::remove_switch({"-client=x"}, "client").empty());
+    }
+
+    SECTION("Value following")
+    {
+        REQUIRE(flow::remove_switch({"a", "--client", "x", "b"}, "client")
+            == arguments({"a", "b"}));
+        REQUIRE(flow::remove_switch({"a", "--client"}, "client")
+            == arguments({"a"}));
+    }
+
+    SECTION("Other arguments")
+    {
+        const arguments input {"--clients=x", "client", "--daemon=y", "-"};
+        REQUIRE(flow::remove_switch(input, "client") == input);
+    }
+}
@@ -0,0 +1,105 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#include "flow/file_saver_archive.h"
+#include <sstream>
+#include "io/memory_byte_stream.h"
+#include "test_support/catch.h"
+
+using namespace au;
+
+static bstr save_files(const flow::ArchiveFormat format)
+{
+    std::stringstream output;
+    {
+        const flow::FileSaverArchive file_saver(output, format);
+        REQUIRE(file_saver.save(
+            std::make_shared<io::File>("dir/test.txt", "abc"_b))
+                == "dir/test.txt");
+        REQUIRE(file_saver.save(
+            std::make_shared<io::File>("dir/test.txt", "defg"_b))
+                == "dir/test(1).txt");
+        REQUIRE(file_saver.get_saved_file_count() == 2);
+    }
+    return bstr(output.str());
+}
+
+TEST_CASE("FileSaverArchive", "[core]")
+{
+    SECTION("Tar")
+    {
+        io::MemoryByteStream stream(save_files(flow::ArchiveFormat::Tar));
+        REQUIRE(stream.size() == 512 * 6);
+
+        REQUIRE(stream.seek(0).read_to_zero() == "dir/test.txt"_b);
+        REQUIRE(stream.seek(124).read_to_zero() == "00000000003"_b);
+        REQUIRE(stream.seek(257).read_to_zero() == "ustar"_b);
+        REQUIRE(stream.seek(512).read(3) == "abc"_b);
+
+        REQUIRE(stream.seek(1024).read_to_zero() == "dir/test(1).txt"_b);
+        REQUIRE(stream.seek(1024 + 124).read_to_zero() == "00000000004"_b);
+        REQUIRE(stream.seek(1536).read(4) == "defg"_b);
+
+        REQUIRE(stream.seek(2048).read_to_eof() == bstr(1024));
+    }
+
+    SECTION("Tar with deduplication")
+    {
+        std::stringstream output;
+        {
+            const flow::FileSaverArchive file_saver(
+                output, flow::ArchiveFormat::Tar, true);
+            file_saver.save(std::make_shared<io::File>("a.txt", "abc"_b));
+            file_saver.save(std::make_shared<io::File>("b.txt", "abc"_b));
+        }
+        io::MemoryByteStream stream((bstr(output.str())));
+        REQUIRE(stream.size() == 512 * 5);
+        REQUIRE(stream.seek(1024).read_to_zero() == "b.txt"_b);
+        REQUIRE(stream.seek(1024 + 124).read_to_zero() == "00000000000"_b);
+        REQUIRE(stream.seek(1024 + 156).read(1) == "1"_b);
+        REQUIRE(stream.seek(1024 + 157).read_to_zero() == "a.txt"_b);
+    }
+
+    SECTION("Zip")
+    {
+        io::MemoryByteStream stream(save_files(flow::ArchiveFormat::Zip));
+
+        REQUIRE(stream.seek(0).read_le<u32>() == 0x04034B50);
+        REQUIRE(stream.seek(14).read_le<u32>() == 0x352441C2);
+        REQUIRE(stream.seek(18).read_le<u32>() == 3);
+        REQUIRE(stream.seek(26).read_le<u16>() == 12);
+        REQUIRE(stream.seek(30).read(12) == "dir/test.txt"_b);
+        REQUIRE(stream.read(3) == "abc"_b);
+
+        const auto second_offset = stream.pos();
+        REQUIRE(stream.read_le<u32>() == 0x04034B50);
+        REQUIRE(stream.seek(second_offset + 30).read(15)
+            == "dir/test(1).txt"_b);
+        REQUIRE(stream.read(4) == "defg"_b);
+
+        stream.seek(stream.size() - 22);
+        REQUIRE(stream.read_le<u32>() == 0x06054B50);
+        stream.skip(4);
+        REQUIRE(stream.read_le<u16>() == 2);
+        REQUIRE(stream.read_le<u16>() == 2);
+        const auto directory_size = stream.read_le<u32>();
+        const auto directory_offset = stream.read_le<u32>();
+        REQUIRE(directory_offset == stream.size() - 22 - directory_size);
+        REQUIRE(stream.seek(directory_offset).read_le<u32>() == 0x02014B50);
+        REQUIRE(stream.seek(directory_offset + 42).read_le<u32>() == 0);
+    }
+}
@@ -95,4 +95,46 @@ TEST_CASE("FileSaver", "[core]")
         const flow::FileSaverHdd file_saver(".", true);
         do_test_overwriting(file_saver, file_saver, true);
     }
+
+    SECTION("Deduplication links identical files")
+    {
+        const io::path path1 = "test1.txt";
+        const io::path path2 = "test2.txt";
+        const flow::FileSaverHdd file_saver(".", true, true);
+        file_saver.save(std::make_shared<io::File>(path1, "test"_b));
+        file_saver.save(std::make_shared<io::File>(path2, "test"_b));
+        REQUIRE(file_saver.get_saved_file_count() == 2);
+        REQUIRE(boost::filesystem::hard_link_count(path2.str()) == 2);
+        {
+            io::FileByteStream file_stream(path2, io::FileMode::Read);
+            REQUIRE(file_stream.read_to_eof() == "test"_b);
+        }
+        io::remove(path1);
+        io::remove(path2);
+    }
+
+    SECTION("Overwriting a linked file leaves its duplicates intact")
+    {
+        const io::path path1 = "test1.txt";
+        const io::path path2 = "test2.txt";
+        {
+            const flow::FileSaverHdd file_saver(".", true, true);
+            file_saver.save(std::make_shared<io::File>(path1, "test"_b));
+            file_saver.save(std::make_shared<io::File>(path2, "test"_b));
+        }
+        {
+            const flow::FileSaverHdd file_saver(".", true);
+            file_saver.save(std::make_shared<io::File>(path2, "new"_b));
+        }
+        {
+            io::FileByteStream file_stream(path1, io::FileMode::Read);
+            REQUIRE(file_stream.read_to_eof() == "test"_b);
+        }
+        {
+            io::FileByteStream file_stream(path2, io::FileMode::Read);
+            REQUIRE(file_stream.read_to_eof() == "new"_b);
+        }
+        io::remove(path1);
+        io::remove(path2);
+    }
 }
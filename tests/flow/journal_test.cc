@@ -0,0 +1,99 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#include "flow/journal.h"
+#include "io/file_system.h"
+#include "test_support/catch.h"
+
+using namespace au;
+
+static const io::path journal_path = "test.journal";
+
+TEST_CASE("Journal", "[flow]")
+{
+    SECTION("Disabled journal")
+    {
+        flow::Journal journal;
+        REQUIRE(!journal.is_enabled());
+        REQUIRE(!journal.is_input_done("input"));
+    }
+
+    SECTION("Resuming")
+    {
+        {
+            flow::Journal journal(journal_path, false);
+            REQUIRE(journal.is_enabled());
+            journal.mark_entry_done("a\t1\t2", "dir/entry.txt");
+            journal.mark_input_done("b\t3\t4", "dec/name");
+            REQUIRE(journal.is_entry_done("a\t1\t2", "dir/entry.txt"));
+        }
+        {
+            flow::Journal journal(journal_path, true);
+            REQUIRE(journal.is_entry_done("a\t1\t2", "dir/entry.txt"));
+            REQUIRE(!journal.is_entry_done("a\t1\t2", "dir/other.txt"));
+            REQUIRE(!journal.is_input_done("a\t1\t2"));
+            REQUIRE(journal.is_input_done("b\t3\t4"));
+        }
+        {
+            flow::Journal journal(journal_path, false);
+            REQUIRE(!journal.is_input_done("b\t3\t4"));
+        }
+        io::remove(journal_path);
+    }
+
+    SECTION("Output directory that doesn't exist yet")
+    {
+        const io::path dir = "test_journal_dir";
+        const auto path = dir / "nested" / "test.journal";
+        REQUIRE(!io::exists(dir));
+        {
+            flow::Journal journal(path, true);
+            REQUIRE(journal.is_enabled());
+            journal.mark_input_done("a\t1\t2", "dec/name");
+        }
+        {
+            flow::Journal journal(path, true);
+            REQUIRE(journal.is_input_done("a\t1\t2"));
+        }
+        io::remove(path);
+        io::remove(dir / "nested");
+        io::remove(dir);
+    }
+
+    SECTION("Progress tracking")
+    {
+        {
+            flow::Journal journal(journal_path, false);
+            {
+                const auto input_progress
+                    = std::make_shared<flow::JournalProgress>(
+                        journal, "a\t1\t2", "", nullptr);
+                const auto entry1_progress
+                    = std::make_shared<flow::JournalProgress>(
+                        journal, "a\t1\t2", "entry1", input_progress);
+                const auto entry2_progress
+                    = std::make_shared<flow::JournalProgress>(
+                        journal, "a\t1\t2", "entry2", input_progress);
+                entry2_progress->fail();
+            }
+            REQUIRE(journal.is_entry_done("a\t1\t2", "entry1"));
+            REQUIRE(!journal.is_entry_done("a\t1\t2", "entry2"));
+            REQUIRE(!journal.is_input_done("a\t1\t2"));
+        }
+        io::remove(journal_path);
+    }
+}
@@ -0,0 +1,49 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#include "flow/json.h"
+#include "test_support/catch.h"
+
+using namespace au;
+
+TEST_CASE("Flat JSON objects", "[flow]")
+{
+    SECTION("Round trip")
+    {
+        const std::string tricky = "a\"b\\c\nd\te\x01";
+        const auto object = flow::json::parse_flat_object(
+            "{\"cwd\": \"" + flow::json::escape(tricky) + "\", "
+            "\"args\": [\"x\", \"y\"], \"exit_code\": -5}");
+        REQUIRE(object.strings.at("cwd") == tricky);
+        REQUIRE(object.arrays.at("args")
+            == std::vector<std::string>({"x", "y"}));
+        REQUIRE(object.numbers.at("exit_code") == -5);
+    }
+
+    SECTION("Empty containers")
+    {
+        const auto object = flow::json::parse_flat_object("{\"a\":[]}");
+        REQUIRE(object.arrays.at("a").empty());
+        REQUIRE(flow::json::parse_flat_object("{}").strings.empty());
+    }
+
+    SECTION("Malformed input")
+    {
+        REQUIRE_THROWS(flow::json::parse_flat_object("{\"a\":"));
+        REQUIRE_THROWS(flow::json::parse_flat_object("{\"a\":\"b"));
+    }
+}
@@ -0,0 +1,70 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#include "flow/path_filter.h"
+#include "test_support/catch.h"
+
+using namespace au;
+
+TEST_CASE("Path filter", "[flow]")
+{
+    flow::PathFilter filter;
+
+    SECTION("Empty filter accepts everything")
+    {
+        REQUIRE(filter.is_empty());
+        REQUIRE(filter.accepts("dir/file.txt"));
+    }
+
+    SECTION("Globs without slashes match file names")
+    {
+        filter.add_include_pattern("*.PNG");
+        REQUIRE(filter.accepts("dir/sub/image.png"));
+        REQUIRE(!filter.accepts("dir/sub/image.jpg"));
+    }
+
+    SECTION("Globs with slashes match whole paths")
+    {
+        filter.add_include_pattern("dir/*.txt");
+        REQUIRE(filter.accepts("dir/file.txt"));
+        REQUIRE(!filter.accepts("dir/sub/file.txt"));
+        filter.add_include_pattern("dir/**.txt");
+        REQUIRE(filter.accepts("dir/sub/file.txt"));
+    }
+
+    SECTION("Regular expressions")
+    {
+        filter.add_include_pattern("regex:^bg[0-9]+");
+        REQUIRE(filter.accepts("bg01.png"));
+        REQUIRE(!filter.accepts("ev01.png"));
+    }
+
+    SECTION("Excludes take precedence")
+    {
+        filter.add_include_pattern("*.png");
+        filter.add_exclude_pattern("secret*");
+        REQUIRE(filter.accepts("image.png"));
+        REQUIRE(!filter.accepts("secret.png"));
+    }
+
+    SECTION("Explicit paths")
+    {
+        filter.add_included_path("dir/file.txt");
+        REQUIRE(filter.accepts("dir/file.txt"));
+        REQUIRE(!filter.accepts("dir/other.txt"));
+    }
+}
@@ -0,0 +1,103 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#include "flow/task_scheduler.h"
+#include <atomic>
+#include "algo/range.h"
+#include "test_support/catch.h"
+
+using namespace au;
+using namespace au::flow;
+
+namespace
+{
+    class TestTask final : public ITask
+    {
+    public:
+        TestTask(
+            TaskScheduler &task_scheduler,
+            std::atomic<int> &counter,
+            const size_t children);
+
+        bool work() const override;
+
+    private:
+        TaskScheduler &task_scheduler;
+        std::atomic<int> &counter;
+        const size_t children;
+    };
+}
+
+TestTask::TestTask(
+    TaskScheduler &task_scheduler,
+    std::atomic<int> &counter,
+    const size_t children) :
+        task_scheduler(task_scheduler),
+        counter(counter),
+        children(children)
+{
+}
+
+bool TestTask::work() const
+{
+    counter++;
+    for (const auto i : algo::range(children))
+    {
+        task_scheduler.push_back(
+            std::make_shared<TestTask>(task_scheduler, counter, 0));
+    }
+    return counter % 2 == 0;
+}
+
+TEST_CASE("Task scheduler", "[flow]")
+{
+    TaskScheduler task_scheduler;
+    std::atomic<int> counter(0);
+
+    SECTION("Runs tasks pushed while running")
+    {
+        for (const auto thread_count : {1, 4})
+        {
+            counter = 0;
+            for (const auto i : algo::range(10))
+            {
+                task_scheduler.push_back(
+                    std::make_shared<TestTask>(task_scheduler, counter, 3));
+            }
+            const auto result = task_scheduler.run(thread_count);
+            REQUIRE(counter == 40);
+            REQUIRE(result.success_count + result.error_count == 40);
+            REQUIRE(result.success_count == 20);
+        }
+    }
+
+    SECTION("Can run with nothing to do")
+    {
+        const auto result = task_scheduler.run(2);
+        REQUIRE(result.success_count == 0);
+        REQUIRE(result.error_count == 0);
+    }
+
+    SECTION("Drops pending tasks when cleared")
+    {
+        task_scheduler.push_back(
+            std::make_shared<TestTask>(task_scheduler, counter, 0));
+        task_scheduler.clear();
+        task_scheduler.run(2);
+        REQUIRE(counter == 0);
+    }
+}
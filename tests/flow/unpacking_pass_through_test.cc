@@ -0,0 +1,163 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#include "dec/base_archive_decoder.h"
+#include "dec/base_image_decoder.h"
+#include "test_support/catch.h"
+#include "test_support/common.h"
+#include "test_support/file_support.h"
+#include "test_support/flow_support.h"
+
+using namespace au;
+using namespace au::dec;
+
+namespace
+{
+    class TestImageDecoder final : public BaseImageDecoder
+    {
+    protected:
+        bool is_canonical_format() const override;
+
+        bool is_recognized_impl(io::File &input_file) const override;
+
+        res::Image decode_impl(
+            const Logger &logger, io::File &input_file) const override;
+    };
+
+    class TestArchiveDecoder final : public BaseArchiveDecoder
+    {
+    public:
+        std::vector<std::string> get_linked_formats() const override;
+
+    protected:
+        bool is_recognized_impl(io::File &input_file) const override;
+
+        std::unique_ptr<ArchiveMeta> read_meta_impl(
+            const Logger &logger, io::File &input_file) const override;
+
+        std::unique_ptr<io::File> read_file_impl(
+            const Logger &logger,
+            io::File &input_file,
+            const ArchiveMeta &m,
+            const ArchiveEntry &e) const override;
+    };
+}
+
+static std::unique_ptr<Registry> create_registry(
+    const std::vector<std::string> &args = {})
+{
+    auto registry = Registry::create_mock();
+    registry->add_decoder(
+        "test/test-archive",
+        []() { return std::make_shared<TestArchiveDecoder>(); });
+    registry->add_decoder(
+        "test/test-image",
+        [args]()
+        {
+            auto decoder = std::make_shared<TestImageDecoder>();
+            ArgParser arg_parser;
+            for (const auto &decorator : decoder->get_arg_parser_decorators())
+                decorator.register_cli_options(arg_parser);
+            arg_parser.parse(args);
+            for (const auto &decorator : decoder->get_arg_parser_decorators())
+                decorator.parse_cli_options(arg_parser);
+            return decoder;
+        });
+    return registry;
+}
+
+bool TestImageDecoder::is_canonical_format() const
+{
+    return true;
+}
+
+bool TestImageDecoder::is_recognized_impl(io::File &input_file) const
+{
+    return input_file.path.has_extension("rgb");
+}
+
+res::Image TestImageDecoder::decode_impl(
+    const Logger &logger, io::File &input_file) const
+{
+    return res::Image(1, 1);
+}
+
+std::vector<std::string> TestArchiveDecoder::get_linked_formats() const
+{
+    return {"test/test-image"};
+}
+
+bool TestArchiveDecoder::is_recognized_impl(io::File &input_file) const
+{
+    return input_file.path.has_extension("arc");
+}
+
+std::unique_ptr<ArchiveMeta> TestArchiveDecoder::read_meta_impl(
+    const Logger &logger, io::File &input_file) const
+{
+    auto meta = std::make_unique<ArchiveMeta>();
+    auto entry = std::make_unique<PlainArchiveEntry>();
+    entry->path = "image.rgb";
+    entry->offset = 0;
+    entry->size = input_file.stream.size();
+    meta->entries.push_back(std::move(entry));
+    return meta;
+}
+
+std::unique_ptr<io::File> TestArchiveDecoder::read_file_impl(
+    const Logger &logger,
+    io::File &input_file,
+    const ArchiveMeta &,
+    const ArchiveEntry &e) const
+{
+    const auto entry = static_cast<const PlainArchiveEntry*>(&e);
+    const auto data = input_file.stream.seek(entry->offset).read(entry->size);
+    return std::make_unique<io::File>(entry->path, data);
+}
+
+TEST_CASE("Nested files in canonical formats are saved as-is", "[flow]")
+{
+    const auto registry = create_registry();
+    io::File dummy_file("archive.arc", "raw image"_b);
+
+    const auto saved_files = tests::flow_unpack(*registry, true, dummy_file);
+    REQUIRE(saved_files.size() == 1);
+    tests::compare_paths(saved_files[0]->path, "archive.arc/image.png");
+    REQUIRE(saved_files[0]->stream.read_to_eof() == "raw image"_b);
+}
+
+TEST_CASE("Nested files are re-encoded with --force-reencode", "[flow]")
+{
+    const auto registry = create_registry({"--force-reencode"});
+    io::File dummy_file("archive.arc", "raw image"_b);
+
+    const auto saved_files = tests::flow_unpack(*registry, true, dummy_file);
+    REQUIRE(saved_files.size() == 1);
+    tests::compare_paths(saved_files[0]->path, "archive.arc/image.png");
+    REQUIRE(saved_files[0]->stream.read_to_eof() != "raw image"_b);
+}
+
+TEST_CASE("Input files in canonical formats are re-encoded", "[flow]")
+{
+    const auto registry = create_registry();
+    io::File dummy_file("image.rgb", "raw image"_b);
+
+    const auto saved_files = tests::flow_unpack(*registry, true, dummy_file);
+    REQUIRE(saved_files.size() == 1);
+    tests::compare_paths(saved_files[0]->path, "image.png");
+    REQUIRE(saved_files[0]->stream.read_to_eof() != "raw image"_b);
+}
@@ -0,0 +1,74 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#include "io/span_reader.h"
+#include "io/span_writer.h"
+#include "io/memory_byte_stream.h"
+#include "test_support/catch.h"
+
+using namespace au;
+
+TEST_CASE("SpanReader", "[io][stream]")
+{
+    SECTION("Reading primitives")
+    {
+        const bstr data = "\x01\x02\x03\x04\x05\x06\x07"_b;
+        io::SpanReader reader(data);
+        REQUIRE(reader.read<u8>() == 1);
+        REQUIRE(reader.read_le<u16>() == 0x0302);
+        REQUIRE(reader.read_be<u32>() == 0x04050607);
+        REQUIRE(reader.eof());
+        REQUIRE_THROWS(reader.read<u8>());
+    }
+
+    SECTION("Reading strings")
+    {
+        io::SpanReader reader("abc\x00" "def\x00\x00xyz"_b);
+        REQUIRE(reader.read_to_zero() == "abc"_b);
+        REQUIRE(reader.read_to_zero(5) == "def"_b);
+        REQUIRE(reader.read_to_eof() == "xyz"_b);
+        reader.seek(4);
+        REQUIRE(reader.read(3) == "def"_b);
+        reader.skip(-3);
+        REQUIRE(reader.pos() == 4);
+        REQUIRE_THROWS(reader.seek(13));
+        REQUIRE_THROWS(reader.skip(-5));
+    }
+
+    SECTION("Taking a region of a byte stream")
+    {
+        io::MemoryByteStream input_stream("xxabcdyy"_b);
+        input_stream.seek(2);
+        io::SpanReader reader(input_stream, 4);
+        REQUIRE(input_stream.pos() == 6);
+        REQUIRE(reader.size() == 4);
+        REQUIRE(reader.read_to_eof() == "abcd"_b);
+        REQUIRE_THROWS(io::SpanReader(input_stream, 3));
+    }
+}
+
+TEST_CASE("SpanWriter", "[io][stream]")
+{
+    bstr output(7);
+    io::SpanWriter writer(output);
+    writer.write<u8>(1);
+    writer.write_le<u16>(0x0302);
+    writer.write_be<u32>(0x04050607);
+    REQUIRE(writer.eof());
+    REQUIRE_THROWS(writer.write<u8>(0));
+    REQUIRE(output == "\x01\x02\x03\x04\x05\x06\x07"_b);
+}
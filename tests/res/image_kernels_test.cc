@@ -0,0 +1,84 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#include "res/image_kernels.h"
+#include "test_support/catch.h"
+
+using namespace au;
+
+TEST_CASE("Image kernels", "[res]")
+{
+    SECTION("Scattering row-interleaved planes")
+    {
+        res::Image image(2, 2);
+        const auto input = "\x01\x02\x03\x04\x05\x06\x07\x08"_b;
+        res::scatter_channel(image, 0, input.get<u8>(), input.size(), 4);
+        res::scatter_channel(
+            image, 1, input.get<u8>() + 2, input.size() - 2, 4);
+        REQUIRE(image.at(0, 0).b == 1);
+        REQUIRE(image.at(1, 0).b == 2);
+        REQUIRE(image.at(0, 0).g == 3);
+        REQUIRE(image.at(1, 1).b == 6);
+        REQUIRE(image.at(1, 1).g == 8);
+        REQUIRE_THROWS(
+            res::scatter_channel(image, 0, input.get<u8>(), 5, 4));
+    }
+
+    SECTION("Scattering 2x2 blocks with odd edges")
+    {
+        res::Image image(3, 3);
+        const auto input = "ABCDEFGHIJKLMNOP"_b;
+        REQUIRE(res::scatter_channel_blocks_2x2(
+            image, 2, input.get<u8>(), input.size()) == 16);
+        REQUIRE(image.at(0, 0).r == 'A');
+        REQUIRE(image.at(0, 1).r == 'B');
+        REQUIRE(image.at(1, 0).r == 'C');
+        REQUIRE(image.at(1, 1).r == 'D');
+        REQUIRE(image.at(2, 0).r == 'E');
+        REQUIRE(image.at(2, 1).r == 'F');
+        REQUIRE(image.at(0, 2).r == 'I');
+        REQUIRE(image.at(1, 2).r == 'K');
+        REQUIRE(image.at(2, 2).r == 'M');
+        REQUIRE_THROWS(res::scatter_channel_blocks_2x2(
+            image, 2, input.get<u8>(), 15));
+    }
+
+    SECTION("Reconstructing deltas")
+    {
+        res::Image image(3, 2);
+        res::fill_channel(image, 3, 1);
+        image.at(0, 0).a = 10;
+        res::apply_horizontal_delta(image, 3, res::DeltaKind::Add);
+        REQUIRE(image.at(2, 0).a == 12);
+        REQUIRE(image.at(2, 1).a == 3);
+        res::apply_vertical_delta(image, 3, res::DeltaKind::Subtract);
+        REQUIRE(image.at(0, 1).a == 9);
+        REQUIRE(image.at(2, 1).a == 9);
+    }
+
+    SECTION("Reconstructing averages")
+    {
+        res::Image image(2, 2);
+        res::fill_channel(image, 0, 2);
+        image.at(0, 0).b = 20;
+        res::apply_average_delta(image, 0, res::DeltaKind::Subtract);
+        REQUIRE(image.at(0, 0).b == 20);
+        REQUIRE(image.at(1, 0).b == 18);
+        REQUIRE(image.at(0, 1).b == 18);
+        REQUIRE(image.at(1, 1).b == 16);
+    }
+}
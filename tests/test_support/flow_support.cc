@@ -37,11 +37,15 @@ std::vector<std::shared_ptr<io::File>> tests::flow_unpack(
             saved_files.push_back(saved_file);
         });
 
+    const flow::PathFilter path_filter;
+    flow::Journal journal;
     const auto name_list = registry.get_decoder_names();
     flow::ParallelUnpackerContext context(
         dummy_logger,
         file_saver,
         registry,
+        path_filter,
+        journal,
         enable_nested_decoding,
         {},
         std::set<std::string>(name_list.begin(), name_list.end()));